@@ -23,9 +23,11 @@ private:
     std::vector<Attitude> poses;
     int current_pose_idx = 0;
     Eigen::VectorXd rotation_vec{3};
+    Eigen::Vector3d hold_position{0, 0, 0};
 public:
     HandledDrone(const char* config_file, MAVLinkMessageRelay& connection, Clock& clock) : 
     Drone(config_file, connection, clock) {
+        this->compute_ground_contact = false;
         rotation_vec[0] = 0;
         rotation_vec[1] = 0;
         rotation_vec[2] = -0.5;
@@ -55,16 +57,10 @@ public:
         }
     }
 
-    void fake_ground_transform(boost::chrono::microseconds us) {
-        double dt = (us.count() / 1000000.0);
-        Eigen::Vector3d position = this->get_sensors().get_earth_frame_position(); // NED
-        Eigen::Vector3d velocity = this->get_sensors().get_earth_frame_velocity(); // NED
-        Eigen::Vector3d acceleration = caelus_fdm::body2earth(this->state) * this->get_sensors().get_body_frame_acceleration();
-
-        if (position[2] >= this->ground_height && acceleration[2] * dt + velocity[2] >= 0) {
-            this->state[2] = 0;
-            this->state.segment(3, 3) = Eigen::VectorXd::Zero(3);
-        }
+    // Held in the hand: pinned where it started, the landing gear plays no part
+    void fake_hold_transform() {
+        this->state.segment(0, 3) = this->hold_position;
+        this->state.segment(3, 3) = Eigen::VectorXd::Zero(3);
     }
 
     void next_pose() {
@@ -79,7 +75,7 @@ void HandledDrone::update(boost::chrono::microseconds us) {
     MAVLinkSystem::update(us);
     DynamicObject::update(us);
     this->fake_handling_transform();
-    this->fake_ground_transform(us);
+    this->fake_hold_transform();
     this->_publish_state(us);
 
     if (this->drone_state_processor != NULL) {
@@ -44,7 +44,7 @@ int main()
     
     boost::asio::io_service godot_service;
 
-    SimpleFixedWingController quadController{config_from_file_path(drone_config)};
+    SimpleFixedWingController quadController{ConfigRegistry::shared_instance().get(drone_config)};
     
     ManoeuvrePlan* plan = pitch(drone_config);
     quadController.set_plan(*plan);
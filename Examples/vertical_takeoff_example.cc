@@ -18,7 +18,7 @@ int main()
         boost::chrono::microseconds{1000000 * 3}, // 2 s
     };
     ManoeuvrePlan plan{section_lenghts, manoeuvres};
-    SimpleFixedWingController quadController{config_from_file_path(fixed_wing_config)};
+    SimpleFixedWingController quadController{ConfigRegistry::shared_instance().get(fixed_wing_config)};
     quadController.set_plan(plan);
 
     DroneStateLogger dsLog;
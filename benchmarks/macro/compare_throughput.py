@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Compares a 6dof_throughput report against a baseline and flags regressions.
+
+Scenarios are matched by vehicle count and timestep. A metric regresses when it
+is worse than the baseline by more than its tolerance (relative).
+Exits with status 1 when any scenario regressed, or when a baseline scenario is missing.
+
+Usage: compare_throughput.py current.json [baseline.json] [--tolerance 0.1] [--rss-tolerance 0.1]
+"""
+
+import argparse
+import json
+import os
+import sys
+
+DEFAULT_BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.json")
+
+# metric: (higher is better, tolerance argument)
+METRICS = {
+    "sim_speed": (True, "tolerance"),
+    "ticks_per_s": (True, "tolerance"),
+    "tick_p50_us": (False, "tolerance"),
+    "tick_p99_us": (False, "latency_tail_tolerance"),
+    "peak_rss_kb": (False, "rss_tolerance"),
+}
+
+
+def load_scenarios(path):
+    with open(path) as f:
+        report = json.load(f)
+    return report.get("context", {}), {(s["vehicles"], s["timestep_us"]): s for s in report["scenarios"]}
+
+
+def relative_change(baseline, current, higher_is_better):
+    """Positive when current is worse than baseline."""
+    if baseline == 0:
+        return 0.0
+    change = (current - baseline) / baseline
+    return -change if higher_is_better else change
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("current")
+    parser.add_argument("baseline", nargs="?", default=DEFAULT_BASELINE)
+    parser.add_argument("--tolerance", type=float, default=0.10, help="throughput and median latency (default 0.10)")
+    parser.add_argument("--latency-tail-tolerance", type=float, default=0.25, help="p99 tick latency (default 0.25)")
+    parser.add_argument("--rss-tolerance", type=float, default=0.10, help="peak RSS (default 0.10)")
+    args = parser.parse_args()
+
+    baseline_context, baseline = load_scenarios(args.baseline)
+    current_context, current = load_scenarios(args.current)
+    for key in ("build_type", "duration_s"):
+        if baseline_context.get(key) != current_context.get(key):
+            print("warning: %s differs (baseline %s, current %s)" % (key, baseline_context.get(key), current_context.get(key)))
+
+    regressions = 0
+    print("%-14s %-12s %14s %14s %9s" % ("scenario", "metric", "baseline", "current", "change"))
+    for key in sorted(baseline):
+        name = baseline[key]["name"]
+        if key not in current:
+            print("%-14s missing from current report" % name)
+            regressions += 1
+            continue
+        for metric, (higher_is_better, tolerance_arg) in METRICS.items():
+            before = baseline[key][metric]
+            after = current[key][metric]
+            worse_by = relative_change(before, after, higher_is_better)
+            regressed = worse_by > getattr(args, tolerance_arg)
+            regressions += regressed
+            change = (after - before) / before * 100 if before else 0.0
+            print("%-14s %-12s %14.2f %14.2f %+8.1f%%%s" % (
+                name, metric, before, after, change + 0.0, "  REGRESSION" if regressed else ""))
+
+    for key in sorted(set(current) - set(baseline)):
+        print("%-14s not in baseline" % current[key]["name"])
+
+    if regressions:
+        print("%d regression(s) against %s" % (regressions, args.baseline))
+        return 1
+    print("No regressions against %s" % args.baseline)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
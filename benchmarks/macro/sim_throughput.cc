@@ -0,0 +1,211 @@
+#include <boost/chrono.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "../../src/StandaloneDrone.h"
+#include "../../src/Simulator.h"
+#include "../../src/Controllers/SimpleFixedWingController.h"
+#include "../../src/Helpers/json.hh"
+
+/**
+ * End-to-end simulation throughput.
+ *
+ * Each scenario flies N StandaloneDrones, each driven by its own SimpleFixedWingController
+ * through a climb / hold / roll / pitch / yaw plan, for a fixed simulated duration at a
+ * fixed timestep. Scenarios run in a child process each, so that peak RSS is their own
+ * and model logging can be silenced.
+ *
+ * Writes sim-seconds per wall-second, ticks/s, p50/p99 tick latency and peak RSS as JSON,
+ * to be compared against a baseline with compare_throughput.py.
+ *
+ * Usage: 6dof_throughput [duration s] [output json] [vehicle counts] [timesteps us] [verbose]
+ *        6dof_throughput 5 throughput.json 1,10,100,1000 1000,4000
+ */
+
+#define THROUGHPUT_DRONE_CONFIG SIM6DOF_SOURCE_DIR "/drone_models/small"
+
+struct ScenarioResult {
+    uint64_t ticks;
+    double wall_s;
+    double sim_s;
+    double tick_p50_us;
+    double tick_p99_us;
+    double tick_max_us;
+    long peak_rss_kb;
+};
+
+static std::vector<long> parse_list(const char* list) {
+    std::vector<long> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) values.push_back(atol(item.c_str()));
+    return values;
+}
+
+static double percentile(std::vector<double>& sorted_samples, double p) {
+    if (sorted_samples.empty()) return 0;
+    size_t idx = std::min(sorted_samples.size() - 1, (size_t)std::floor(p / 100.0 * sorted_samples.size()));
+    return sorted_samples[idx];
+}
+
+static ManoeuvrePlan plan_for(boost::chrono::microseconds duration) {
+    std::vector<Manoeuvre> manoeuvres{Manoeuvre::CLIMB, Manoeuvre::HOLD, Manoeuvre::ROLL, Manoeuvre::PITCH, Manoeuvre::YAW};
+    std::vector<boost::chrono::microseconds> section_lengths(manoeuvres.size(), duration / manoeuvres.size());
+    return ManoeuvrePlan{section_lengths, manoeuvres};
+}
+
+/**
+ * Ticks the simulator directly (as Simulator::start does) to time every tick.
+ */
+static ScenarioResult run_scenario(long vehicles_n, long timestep_us, double duration_s) {
+    boost::chrono::microseconds timestep{timestep_us};
+    boost::chrono::microseconds duration{(long long)(duration_s * 1000000)};
+    std::shared_ptr<const DroneConfig> config = ConfigRegistry::shared_instance().get(THROUGHPUT_DRONE_CONFIG);
+
+    std::unique_ptr<Simulator> s(new Simulator({timestep_us, 1, true}));
+    std::vector<std::unique_ptr<SimpleFixedWingController>> controllers;
+    std::vector<std::unique_ptr<StandaloneDrone>> drones;
+    for (long i = 0; i < vehicles_n; i++) {
+        controllers.emplace_back(new SimpleFixedWingController{config});
+        controllers.back()->set_plan(plan_for(duration));
+        drones.emplace_back(new StandaloneDrone{config, s->simulation_clock, *controllers.back()});
+        drones.back()->set_fake_ground_level(0);
+        drones.back()->set_drone_state_processor(*s);
+        s->add_environment_object(*drones.back());
+    }
+
+    uint64_t ticks = duration / timestep;
+    std::vector<double> tick_us;
+    tick_us.reserve(ticks);
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < ticks; i++) {
+        boost::chrono::steady_clock::time_point before = boost::chrono::steady_clock::now();
+        s->update(timestep);
+        boost::chrono::steady_clock::time_point after = boost::chrono::steady_clock::now();
+        tick_us.push_back(boost::chrono::duration_cast<boost::chrono::nanoseconds>(after - before).count() / 1000.0);
+    }
+    double wall_s = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - start).count() / 1000000.0;
+
+    std::sort(tick_us.begin(), tick_us.end());
+    return ScenarioResult{
+        ticks,
+        wall_s,
+        s->simulation_clock.get_current_time_us().count() / 1000000.0,
+        percentile(tick_us, 50),
+        percentile(tick_us, 99),
+        tick_us.empty() ? 0.0 : tick_us.back(),
+        0
+    };
+}
+
+/**
+ * Runs the scenario in a child process and collects its result and peak RSS.
+ */
+static bool run_isolated(long vehicles_n, long timestep_us, double duration_s, bool verbose, ScenarioResult& result) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return false;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        if (!verbose) {
+            int null_fd = open("/dev/null", O_WRONLY);
+            dup2(null_fd, STDOUT_FILENO);
+        }
+        ScenarioResult child_result = run_scenario(vehicles_n, timestep_us, duration_s);
+        ssize_t written = write(fds[1], &child_result, sizeof(child_result));
+        _exit(written == sizeof(child_result) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t received = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    if (received != sizeof(result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Scenario %ld vehicles @ %ld us failed\n", vehicles_n, timestep_us);
+        return false;
+    }
+#ifdef __APPLE__
+    result.peak_rss_kb = usage.ru_maxrss / 1024; // bytes
+#else
+    result.peak_rss_kb = usage.ru_maxrss;
+#endif
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    double duration_s = argc > 1 ? atof(argv[1]) : 5.0;
+    const char* output_path = argc > 2 ? argv[2] : "throughput.json";
+    std::vector<long> vehicle_counts = parse_list(argc > 3 ? argv[3] : "1,10,100,1000");
+    std::vector<long> timesteps_us = parse_list(argc > 4 ? argv[4] : "1000,4000");
+    bool verbose = argc > 5 && atoi(argv[5]) != 0;
+
+    nlohmann::json report;
+    report["context"] = {
+        {"build_type", SIM6DOF_BUILD_TYPE},
+        {"duration_s", duration_s},
+        {"vehicle_config", "drone_models/small"}
+    };
+    report["scenarios"] = nlohmann::json::array();
+
+    printf("%10s %12s %14s %12s %12s %12s %12s\n", "vehicles", "timestep_us", "sim_s/wall_s", "ticks/s", "p50_us", "p99_us", "peak_rss_mb");
+    bool failed = false;
+    for (long timestep_us : timesteps_us) {
+        for (long vehicles_n : vehicle_counts) {
+            ScenarioResult r;
+            if (!run_isolated(vehicles_n, timestep_us, duration_s, verbose, r)) {
+                failed = true;
+                continue;
+            }
+            double speed = r.wall_s > 0 ? r.sim_s / r.wall_s : 0;
+            double ticks_per_s = r.wall_s > 0 ? r.ticks / r.wall_s : 0;
+            printf("%10ld %12ld %14.3f %12.1f %12.1f %12.1f %12.1f\n",
+                vehicles_n, timestep_us, speed, ticks_per_s, r.tick_p50_us, r.tick_p99_us, r.peak_rss_kb / 1024.0);
+
+            report["scenarios"].push_back({
+                {"name", std::to_string(vehicles_n) + "x" + std::to_string(timestep_us) + "us"},
+                {"vehicles", vehicles_n},
+                {"timestep_us", timestep_us},
+                {"ticks", r.ticks},
+                {"wall_s", r.wall_s},
+                {"sim_s", r.sim_s},
+                {"sim_speed", speed},
+                {"ticks_per_s", ticks_per_s},
+                {"tick_p50_us", r.tick_p50_us},
+                {"tick_p99_us", r.tick_p99_us},
+                {"tick_max_us", r.tick_max_us},
+                {"peak_rss_kb", r.peak_rss_kb}
+            });
+        }
+    }
+
+    std::ofstream output(output_path);
+    if (!output) {
+        fprintf(stderr, "Could not write %s\n", output_path);
+        return 1;
+    }
+    output << report.dump(2) << std::endl;
+    printf("Report written to %s\n", output_path);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+#include <atomic>
+#include <cstdint>
+#include <cerrno>
+#include <cstdlib>
+#include "BenchSupport.h"
+
+/**
+ * Counts heap allocations by interposing the C allocator, which both
+ * operator new and Eigen's dynamic storage end up calling.
+ */
+
+static std::atomic<uint64_t> allocations{0};
+
+uint64_t allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+#ifdef __GLIBC__
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    void* p = memalign(alignment, size);
+    if (p == NULL) return ENOMEM;
+    *ptr = p;
+    return 0;
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+}
+
+#endif // __GLIBC__
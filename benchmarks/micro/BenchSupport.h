@@ -0,0 +1,68 @@
+#ifndef __BENCHSUPPORT_H__
+#define __BENCHSUPPORT_H__
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include <Eigen/Eigen>
+#include "../../src/Containers/ConfigRegistry.h"
+#include "../../src/Interfaces/DynamicObject.h"
+#include "../../src/Interfaces/Clock.h"
+
+// Vehicle used by every benchmark, independent of the working directory
+#define BENCH_DRONE_CONFIG SIM6DOF_SOURCE_DIR "/drone_models/small"
+#define BENCH_TIMESTEP_US 4000
+
+// Heap allocations made by the process so far (0 without glibc)
+uint64_t allocation_count();
+
+// Reports the allocations since `allocations_before` as "allocs/op"
+static inline void report_allocations(benchmark::State& state, uint64_t allocations_before) {
+    state.counters["allocs/op"] = benchmark::Counter(
+        (double)(allocation_count() - allocations_before), benchmark::Counter::kAvgIterations);
+}
+
+static inline std::shared_ptr<const DroneConfig> bench_config() {
+    return ConfigRegistry::shared_instance().get(BENCH_DRONE_CONFIG);
+}
+
+/**
+ * Quadrotor in forward flight 10 m above the ground,
+ * banked and pitched, rotors spun up close to hover.
+ */
+static inline Eigen::VectorXd bench_state() {
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(DYNAMIC_OBJECT_STATE_SIZE + DYNAMIC_OBJECT_VTOL_ROTORS);
+    x.segment<3>(0) << 20, -5, -10;
+    x.segment<3>(3) << 12, 0.5, -0.3;
+    x.segment<3>(6) << 0.05, 0.1, 0.8;
+    x.segment<3>(9) << 0.02, -0.01, 0.03;
+    x.tail(DYNAMIC_OBJECT_VTOL_ROTORS).setConstant(7.5);
+    return x;
+}
+
+/**
+ * DynamicObject with its integration internals exposed.
+ * The rotor command is held constant.
+ */
+class BenchVehicle : public DynamicObject {
+public:
+    Eigen::VectorXd rotor_command = Eigen::VectorXd::Constant(DYNAMIC_OBJECT_VTOL_ROTORS, 7.5);
+
+    BenchVehicle(Clock& clock) : DynamicObject(bench_config(), clock) {
+        this->setControllerVTOL([this](double t) { return this->rotor_command; });
+        this->state = bench_state();
+    }
+
+    using DynamicObject::step_dynamics;
+    using DynamicObject::integration_step;
+
+    void set_state(const Eigen::VectorXd& x) { this->state = x; }
+
+    // Level and at rest on its landing gear, every leg in contact
+    Eigen::VectorXd landed_state() {
+        Eigen::VectorXd x = Eigen::VectorXd::Zero(this->state.size());
+        x[2] = this->ground_contact.resting_down_position(0, this->config.mass);
+        return x;
+    }
+};
+
+#endif // __BENCHSUPPORT_H__
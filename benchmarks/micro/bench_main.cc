@@ -0,0 +1,15 @@
+#include <benchmark/benchmark.h>
+
+/**
+ * Microbenchmarks of the dynamics hot path.
+ * Build with the "bench" preset to measure the optimised code:
+ *     cmake --preset bench && cmake --build --preset bench && ./_bench_build/6dof_bench
+ */
+int main(int argc, char** argv) {
+    benchmark::AddCustomContext("6dof_build_type", SIM6DOF_BUILD_TYPE);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "BenchSupport.h"
+#include "../../src/Helpers/rotationMatrix.h"
+#include "../../src/Helpers/angleRateRotationMatrix.h"
+
+#pragma mark EQUATIONS_OF_MOTION
+
+// One evaluation of the state derivative, as done at every solver stage
+static void BM_StepDynamics(benchmark::State& state) {
+    Clock clock;
+    BenchVehicle vehicle{clock};
+    boost::chrono::microseconds us{BENCH_TIMESTEP_US};
+    // Caches the per tick force models
+    vehicle.update(us);
+
+    Eigen::VectorXd x = state.range(0) ? vehicle.landed_state() : bench_state();
+    Eigen::VectorXd dx = Eigen::VectorXd::Zero(x.size());
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        vehicle.step_dynamics(us, x, dx, 0);
+        benchmark::DoNotOptimize(dx.data());
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_StepDynamics)->ArgName("ground_contact")->Arg(0)->Arg(1);
+
+// One solver step (dopri5, 6 stages) from the same initial state
+static void BM_IntegrationStep(benchmark::State& state) {
+    Clock clock;
+    BenchVehicle vehicle{clock};
+    boost::chrono::microseconds us{BENCH_TIMESTEP_US};
+    vehicle.update(us);
+
+    const Eigen::VectorXd x0 = bench_state();
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        vehicle.set_state(x0);
+        vehicle.integration_step(us);
+        benchmark::DoNotOptimize(vehicle.get_vector_state().data());
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_IntegrationStep);
+
+// A whole tick: wind, force models, integration and battery
+static void BM_DynamicObjectUpdate(benchmark::State& state) {
+    Clock clock;
+    BenchVehicle vehicle{clock};
+    boost::chrono::microseconds us{BENCH_TIMESTEP_US};
+
+    const Eigen::VectorXd x0 = bench_state();
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        vehicle.set_state(x0);
+        vehicle.update(us);
+        benchmark::DoNotOptimize(vehicle.get_vector_state().data());
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_DynamicObjectUpdate);
+
+#pragma mark ROTATIONS
+
+static void BM_Body2Earth(benchmark::State& state) {
+    const Eigen::VectorXd x = bench_state();
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        Eigen::Matrix3d r = caelus_fdm::body2earth(x);
+        benchmark::DoNotOptimize(r.data());
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_Body2Earth);
+
+static void BM_AngularVelocity2EulerRate(benchmark::State& state) {
+    const Eigen::VectorXd x = bench_state();
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        Eigen::Matrix3d r = caelus_fdm::angularVelocity2eulerRate(x);
+        benchmark::DoNotOptimize(r.data());
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_AngularVelocity2EulerRate);
@@ -0,0 +1,113 @@
+#include "BenchSupport.h"
+#include "../../src/DroneSensors.h"
+#include "../../src/Interfaces/DroneStateEncoder.h"
+
+#define BENCH_LAT 55.573712
+#define BENCH_LON -5.1303470010000005
+#define BENCH_ALT 2600 // mm
+
+/**
+ * Vehicle with its sensor suite, sampled once
+ * so that every encoder packs the same frame.
+ */
+class BenchEncoder : public DroneStateEncoder {
+public:
+    Clock clock;
+    BenchVehicle vehicle{clock};
+    DroneSensors sensors{vehicle, LatLonAlt{BENCH_LAT, BENCH_LON, BENCH_ALT}};
+    SensorFrame frame;
+    mavlink_message_t msg;
+
+    BenchEncoder() {
+        this->vehicle.update(boost::chrono::microseconds{BENCH_TIMESTEP_US});
+        this->sensors.integrate_imu(boost::chrono::microseconds{BENCH_TIMESTEP_US});
+        this->sensors.sample_frame(this->frame);
+    }
+
+    uint64_t get_sim_time() override { return this->clock.get_current_time_us().count(); }
+    Sensors& get_sensors() override { return this->sensors; }
+    const Eigen::VectorXd& get_state() override { return this->vehicle.get_vector_state(); }
+    const Eigen::VectorXd& get_dx_state() override { return this->vehicle.get_vector_dx_state(); }
+};
+
+#pragma mark SENSORS
+
+static void BM_SampleFrame(benchmark::State& state) {
+    BenchEncoder encoder;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        encoder.sensors.sample_frame(encoder.frame);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_SampleFrame);
+
+static void BM_GetLatLonAlt(benchmark::State& state) {
+    BenchEncoder encoder;
+    encoder.sensors.set_geodetic_accuracy((GeodeticAccuracy)state.range(0));
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        LatLonAlt lat_lon_alt = encoder.sensors.get_lat_lon_alt();
+        benchmark::DoNotOptimize(lat_lon_alt);
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_GetLatLonAlt)->ArgName("accuracy")->Arg(EXACT)->Arg(FLAT_EARTH);
+
+#pragma mark MESSAGE_BUILDERS
+
+static void BM_HilSensorMsg(benchmark::State& state) {
+    BenchEncoder encoder;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        encoder.hil_sensor_msg(encoder.frame, 1, 1, encoder.msg);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_HilSensorMsg);
+
+static void BM_HilGpsMsg(benchmark::State& state) {
+    BenchEncoder encoder;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        encoder.hil_gps_msg(encoder.frame, 1, 1, encoder.msg);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_HilGpsMsg);
+
+static void BM_HilStateQuaternionMsg(benchmark::State& state) {
+    BenchEncoder encoder;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        encoder.hil_state_quaternion_msg(encoder.frame, 1, 1, encoder.msg);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_HilStateQuaternionMsg);
+
+static void BM_SystemTimeMsg(benchmark::State& state) {
+    BenchEncoder encoder;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        encoder.system_time_msg(1, 1, encoder.msg);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_SystemTimeMsg);
+
+static void BM_BatteryStatusMsg(benchmark::State& state) {
+    BenchEncoder encoder;
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        encoder.battery_status_msg(encoder.vehicle.get_battery_state(), 1, 1, encoder.msg);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_BatteryStatusMsg);
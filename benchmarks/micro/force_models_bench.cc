@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include "BenchSupport.h"
+#include "../../src/ForceModels/Weight.h"
+#include "../../src/ForceModels/Drag.h"
+#include "../../src/ForceModels/ThrustMultirotor.h"
+#include "../../src/ClassExtensions/ThrustFixedWing_Extension.h"
+#include "../../src/ClassExtensions/Aerodynamics_Extension.h"
+
+/**
+ * updateParamsImpl of each force model, as called once per tick by DynamicObject::update.
+ * Controllers return a constant command.
+ */
+template<class FM>
+static void run_force_model(benchmark::State& state, FM& model) {
+    const Eigen::VectorXd x = bench_state();
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        model.updateParamsImpl(0, x);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+
+static void BM_WeightUpdate(benchmark::State& state) {
+    caelus_fdm::Weight model{*bench_config(), G_FORCE};
+    run_force_model(state, model);
+}
+BENCHMARK(BM_WeightUpdate);
+
+static void BM_DragUpdate(benchmark::State& state) {
+    caelus_fdm::Drag model{*bench_config()};
+    model.setWind(Eigen::Vector3d{3, -2, 0});
+    run_force_model(state, model);
+}
+BENCHMARK(BM_DragUpdate);
+
+/**
+ * setRotorSpeeds, as called at every integration stage, for rotors
+ * spread evenly on a ring of the bench vehicle's arm length.
+ */
+static void BM_ThrustMultirotorUpdate(benchmark::State& state) {
+    DroneConfig config = *bench_config();
+    const int n = state.range(0);
+    config.rotors.clear();
+    for (int i = 0; i < n; i++) {
+        double angle = 2 * M_PI * (i + 0.5) / n;
+        Eigen::Vector3d position{config.vtol_lcog * cos(angle), config.vtol_lcog * sin(angle), 0};
+        config.rotors.push_back(RotorConfig(position, i % 2 ? -1 : 1, i, config.vtol_komega));
+    }
+    ThrustMultirotor model{config};
+    const Eigen::VectorXd x = bench_state();
+    const Eigen::VectorXd speeds = Eigen::VectorXd::Constant(n, 7.5);
+    uint64_t allocations = allocation_count();
+    for (auto _ : state) {
+        model.setRotorSpeeds(0, x, speeds);
+        benchmark::ClobberMemory();
+    }
+    report_allocations(state, allocations);
+}
+BENCHMARK(BM_ThrustMultirotorUpdate)->Arg(4)->Arg(6)->Arg(8);
+
+static void BM_ThrustFixedWingUpdate(benchmark::State& state) {
+    ThrustFixedWing model{*bench_config()};
+    Eigen::VectorXd command = Eigen::VectorXd::Constant(1, 100);
+    model.setController([&command](double t) { return command; });
+    run_force_model(state, model);
+}
+BENCHMARK(BM_ThrustFixedWingUpdate);
+
+static void BM_AerodynamicsUpdate(benchmark::State& state) {
+    Aerodynamics model{*bench_config()};
+    Eigen::VectorXd command = Eigen::VectorXd::Constant(2, 0.05);
+    model.setController([&command](double t) { return command; });
+    model.setWind(Eigen::Vector3d{3, -2, 0});
+    run_force_model(state, model);
+}
+BENCHMARK(BM_AerodynamicsUpdate);
+
+/**
+ * Aerodynamics with its static coefficients from a full-envelope table
+ * (alpha every 10 deg, beta, Mach and elevator), written once to a temporary file.
+ */
+static void BM_AerodynamicsTableUpdate(benchmark::State& state) {
+    AeroTableHeader header{};
+    const uint32_t variables[] = {AERO_TABLE_ALPHA, AERO_TABLE_BETA, AERO_TABLE_MACH, AERO_TABLE_DELTA_E};
+    const uint32_t points[] = {37, 11, 5, 9};
+    const double lower[] = {-M_PI, -0.5, 0, -1};
+    const double upper[] = {M_PI, 0.5, 0.2, 1};
+    header.axes_n = 4;
+    std::vector<double> breakpoints;
+    size_t nodes_n = 1;
+    for (int i = 0; i < 4; i++) {
+        header.variables[i] = variables[i];
+        header.points[i] = points[i];
+        for (uint32_t j = 0; j < points[i]; j++) breakpoints.push_back(lower[i] + (upper[i] - lower[i]) * j / (points[i] - 1));
+        nodes_n *= points[i];
+    }
+    std::vector<float> nodes(nodes_n * AERO_TABLE_COEFFICIENTS);
+    for (size_t i = 0; i < nodes.size(); i++) nodes[i] = 0.01f * (i % 97);
+    char path[] = "/tmp/6dof_bench_aero_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || !AeroCoefficientTable::write(path, header, breakpoints, nodes)) {
+        state.SkipWithError("cannot write the aero table");
+        return;
+    }
+    close(fd);
+
+    Aerodynamics model{*bench_config()};
+    model.setCoefficientTable(std::make_shared<AeroCoefficientTable>(path));
+    unlink(path);
+    Eigen::VectorXd command = Eigen::VectorXd::Constant(2, 0.05);
+    model.setController([&command](double t) { return command; });
+    model.setWind(Eigen::Vector3d{3, -2, 0});
+    run_force_model(state, model);
+}
+BENCHMARK(BM_AerodynamicsTableUpdate);
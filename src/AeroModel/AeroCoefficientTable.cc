@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include "AeroCoefficientTable.h"
+
+static size_t breakpoint_count(const AeroTableHeader& header) {
+    size_t count = 0;
+    for (uint32_t i = 0; i < header.axes_n; i++) count += header.points[i];
+    return count;
+}
+
+static size_t node_count(const AeroTableHeader& header) {
+    size_t count = 1;
+    for (uint32_t i = 0; i < header.axes_n; i++) count *= header.points[i];
+    return count;
+}
+
+static bool valid_axes(const AeroTableHeader& header) {
+    if (header.axes_n < 1 || header.axes_n > AERO_TABLE_MAX_AXES) return false;
+    bool used[AERO_TABLE_VARIABLES] = {false};
+    for (uint32_t i = 0; i < header.axes_n; i++) {
+        uint32_t variable = header.variables[i];
+        if (variable >= AERO_TABLE_VARIABLES || used[variable] || header.points[i] == 0) return false;
+        used[variable] = true;
+    }
+    return true;
+}
+
+AeroCoefficientTable::AeroCoefficientTable(const char* path) {
+    memset(&this->header, 0, sizeof(this->header));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Could not open aero table file %s\n", path);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AeroTableHeader)) {
+        fprintf(stderr, "Invalid aero table file %s\n", path);
+        close(fd);
+        return;
+    }
+
+    void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Could not map aero table file %s\n", path);
+        return;
+    }
+
+    memcpy(&this->header, mapping, sizeof(this->header));
+    bool valid = strncmp(this->header.magic, AERO_TABLE_MAGIC, sizeof(this->header.magic)) == 0 &&
+        this->header.version == AERO_TABLE_VERSION &&
+        valid_axes(this->header) &&
+        (size_t)st.st_size == sizeof(AeroTableHeader) + breakpoint_count(this->header) * sizeof(double) +
+            node_count(this->header) * AERO_TABLE_COEFFICIENTS * sizeof(float);
+
+    const double* breakpoints = (const double*)((const char*)mapping + sizeof(AeroTableHeader));
+    for (uint32_t i = 0; valid && i < this->header.axes_n; i++) {
+        this->breakpoints[i] = breakpoints;
+        for (uint32_t j = 1; j < this->header.points[i]; j++) {
+            if (!(breakpoints[j] > breakpoints[j - 1])) valid = false;
+        }
+        breakpoints += this->header.points[i];
+    }
+    if (!valid) {
+        fprintf(stderr, "Invalid aero table file %s\n", path);
+        munmap(mapping, st.st_size);
+        return;
+    }
+
+    this->mapping = mapping;
+    this->mapping_size = st.st_size;
+    this->nodes = (const float*)breakpoints;
+    size_t stride = 1;
+    for (uint32_t i = 0; i < this->header.axes_n; i++) {
+        this->strides[i] = stride;
+        stride *= this->header.points[i];
+    }
+}
+
+AeroCoefficientTable::~AeroCoefficientTable() {
+    if (this->mapping != NULL) munmap(this->mapping, this->mapping_size);
+}
+
+bool AeroCoefficientTable::has_variable(AeroTableVariable variable) const {
+    for (uint32_t i = 0; i < this->header.axes_n; i++) {
+        if (this->header.variables[i] == variable) return true;
+    }
+    return false;
+}
+
+bool AeroCoefficientTable::write(const char* path, AeroTableHeader header, const std::vector<double>& breakpoints, const std::vector<float>& nodes) {
+    strncpy(header.magic, AERO_TABLE_MAGIC, sizeof(header.magic));
+    header.version = AERO_TABLE_VERSION;
+    if (!valid_axes(header) ||
+        breakpoints.size() != breakpoint_count(header) ||
+        nodes.size() != node_count(header) * AERO_TABLE_COEFFICIENTS) {
+        fprintf(stderr, "Aero table breakpoints or node count do not match its header\n");
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Could not write aero table file %s\n", path);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(breakpoints.data(), sizeof(double), breakpoints.size(), file) == breakpoints.size() &&
+        fwrite(nodes.data(), sizeof(float), nodes.size(), file) == nodes.size();
+    fclose(file);
+    return ok;
+}
+
+void AeroCoefficientTable::coefficients_at(const double variables[AERO_TABLE_VARIABLES], double coefficients[AERO_TABLE_COEFFICIENTS]) const {
+    std::fill(coefficients, coefficients + AERO_TABLE_COEFFICIENTS, 0.0);
+    if (this->nodes == NULL) return;
+
+    const uint32_t axes_n = this->header.axes_n;
+    size_t base = 0;
+    // Offset to the upper neighbour (zero along single node axes) and its weight
+    size_t neighbour[AERO_TABLE_MAX_AXES];
+    double weight[AERO_TABLE_MAX_AXES];
+    for (uint32_t i = 0; i < axes_n; i++) {
+        const uint32_t points = this->header.points[i];
+        const double* b = this->breakpoints[i];
+        const double v = variables[this->header.variables[i]];
+        uint32_t index = 0;
+        weight[i] = 0;
+        if (points > 1 && v >= b[points - 1]) {
+            index = points - 2;
+            weight[i] = 1;
+        } else if (points > 1 && v > b[0]) {
+            index = std::upper_bound(b, b + points, v) - b - 1;
+            weight[i] = (v - b[index]) / (b[index + 1] - b[index]);
+        }
+        base += index * this->strides[i];
+        neighbour[i] = points > 1 ? this->strides[i] : 0;
+    }
+
+    for (uint32_t corner = 0; corner < (1u << axes_n); corner++) {
+        double w = 1;
+        size_t node = base;
+        for (uint32_t i = 0; i < axes_n; i++) {
+            if (corner & (1u << i)) {
+                w *= weight[i];
+                node += neighbour[i];
+            } else {
+                w *= 1 - weight[i];
+            }
+        }
+        if (w == 0) continue;
+        const float* c = this->nodes + node * AERO_TABLE_COEFFICIENTS;
+        for (int k = 0; k < AERO_TABLE_COEFFICIENTS; k++) coefficients[k] += w * c[k];
+    }
+}
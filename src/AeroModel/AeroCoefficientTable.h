@@ -0,0 +1,82 @@
+#ifndef __AEROCOEFFICIENTTABLE_H__
+#define __AEROCOEFFICIENTTABLE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * Binary aerodynamic coefficient table format.
+ *
+ * Header:  AeroTableHeader ("6DOFAER" magic, version, axes)
+ * Body:    double breakpoints of each axis (strictly increasing), in axis order,
+ *          then float[6] (CD, CS, CL, Cl, Cm, Cn) per node, first axis fastest
+ *
+ * All values are stored in host byte order; the file is mapped as is.
+ */
+#define AERO_TABLE_MAGIC "6DOFAER"
+#define AERO_TABLE_VERSION 1
+#define AERO_TABLE_MAX_AXES 6
+#define AERO_TABLE_COEFFICIENTS 6
+
+// Variables a table axis can span
+enum AeroTableVariable : uint32_t {
+    AERO_TABLE_ALPHA = 0,       // angle of attack (rad)
+    AERO_TABLE_BETA = 1,        // sideslip (rad)
+    AERO_TABLE_AIRSPEED = 2,    // m/s
+    AERO_TABLE_MACH = 3,
+    AERO_TABLE_DELTA_E = 4,     // elevator deflection (controller units)
+    AERO_TABLE_DELTA_A = 5,     // aileron deflection (controller units)
+    AERO_TABLE_VARIABLES = 6
+};
+
+struct AeroTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t axes_n;
+    uint32_t variables[AERO_TABLE_MAX_AXES];  // AeroTableVariable of each axis
+    uint32_t points[AERO_TABLE_MAX_AXES];     // breakpoints along each axis
+};
+
+/**
+ * Static aerodynamic coefficients over up to 6 axes (e.g. alpha, beta, Mach,
+ * elevator) backed by a memory mapped file, covering the whole envelope
+ * (post-stall included) where the linear derivatives do not.
+ *
+ * Sampled with multilinear interpolation between the 2**axes neighbouring nodes.
+ * Values outside the table are clamped to its boundary.
+ * The table is immutable once loaded and can be shared freely.
+ */
+class AeroCoefficientTable {
+private:
+    AeroTableHeader header;
+    const double* breakpoints[AERO_TABLE_MAX_AXES];
+    const float* nodes = NULL;
+    void* mapping = NULL;
+    size_t mapping_size = 0;
+    size_t strides[AERO_TABLE_MAX_AXES];
+public:
+    AeroCoefficientTable(const char* path);
+    ~AeroCoefficientTable();
+    AeroCoefficientTable(AeroCoefficientTable& t) = delete;
+
+    // False when the file could not be mapped
+    bool is_loaded() const { return this->nodes != NULL; }
+    const AeroTableHeader& get_header() const { return this->header; }
+    bool has_variable(AeroTableVariable variable) const;
+
+    /**
+     * Coefficients at a flight condition.
+     * @param variables : value of each AeroTableVariable, those without an axis are ignored
+     * @param coefficients : CD, CS, CL, Cl, Cm, Cn
+     */
+    void coefficients_at(const double variables[AERO_TABLE_VARIABLES], double coefficients[AERO_TABLE_COEFFICIENTS]) const;
+
+    /**
+     * Writes a table file, e.g. exported from wind tunnel or CFD data.
+     * Magic and version of `header` are filled in.
+     */
+    static bool write(const char* path, AeroTableHeader header, const std::vector<double>& breakpoints, const std::vector<float>& nodes);
+};
+
+#endif // __AEROCOEFFICIENTTABLE_H__
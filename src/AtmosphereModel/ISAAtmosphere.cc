@@ -0,0 +1,72 @@
+#include <cmath>
+#include <algorithm>
+#include "ISAAtmosphere.h"
+#include "../Helpers/constants.h"
+
+#define ISA_TROPOPAUSE_ALT 11000.0
+#define ISA_STRATOSPHERE_ALT 20000.0
+#define ISA_STRATOSPHERE_LAPSE 0.001 // K/m
+#define ISA_HEAT_CAPACITY_RATIO 1.4
+
+ISAAtmosphere::ISAAtmosphere() {
+    size_t n = (size_t)std::round((ISA_TABLE_MAX_ALT - ISA_TABLE_MIN_ALT) / ISA_TABLE_STEP) + 1;
+    this->table.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        this->table[i] = ISAAtmosphere::evaluate(ISA_TABLE_MIN_ALT + i * ISA_TABLE_STEP);
+    }
+    this->inv_step = 1.0 / ISA_TABLE_STEP;
+}
+
+const ISAAtmosphere& ISAAtmosphere::shared_instance() {
+    static ISAAtmosphere instance;
+    return instance;
+}
+
+/**
+ * Layer by layer ISA, with the same constants as the original JMavSim barometer model.
+ */
+AtmosphereState ISAAtmosphere::evaluate(double altitude_m) {
+    const double g_m_r = G_FORCE * K_M / K_R;
+    double temperature, pressure;
+
+    if (altitude_m <= ISA_TROPOPAUSE_ALT) {
+        temperature = K_Tb + K_Lb * altitude_m;
+        pressure = K_Pb * std::pow(K_Tb / temperature, g_m_r / K_Lb);
+    } else {
+        double tropopause_temperature = K_Tb + K_Lb * ISA_TROPOPAUSE_ALT;
+        double tropopause_pressure = K_Pb * std::pow(K_Tb / tropopause_temperature, g_m_r / K_Lb);
+
+        if (altitude_m <= ISA_STRATOSPHERE_ALT) {
+            temperature = tropopause_temperature;
+            pressure = tropopause_pressure * std::exp(-g_m_r * (altitude_m - ISA_TROPOPAUSE_ALT) / temperature);
+        } else {
+            double stratosphere_pressure = tropopause_pressure *
+                std::exp(-g_m_r * (ISA_STRATOSPHERE_ALT - ISA_TROPOPAUSE_ALT) / tropopause_temperature);
+            temperature = tropopause_temperature + ISA_STRATOSPHERE_LAPSE * (altitude_m - ISA_STRATOSPHERE_ALT);
+            pressure = stratosphere_pressure * std::pow(tropopause_temperature / temperature, g_m_r / ISA_STRATOSPHERE_LAPSE);
+        }
+    }
+
+    AtmosphereState state;
+    state.temperature = temperature;
+    state.pressure = pressure;
+    state.density = pressure * K_M / (K_R * temperature);
+    state.speed_of_sound = std::sqrt(ISA_HEAT_CAPACITY_RATIO * K_R / K_M * temperature);
+    return state;
+}
+
+AtmosphereState ISAAtmosphere::at(double altitude_m) const {
+    double f = (altitude_m - ISA_TABLE_MIN_ALT) * this->inv_step;
+    f = std::max(0.0, std::min(f, (double)(this->table.size() - 1)));
+    size_t i = std::min((size_t)f, this->table.size() - 2);
+    double t = f - i;
+
+    const AtmosphereState& lo = this->table[i];
+    const AtmosphereState& hi = this->table[i + 1];
+    AtmosphereState state;
+    state.pressure = lo.pressure + t * (hi.pressure - lo.pressure);
+    state.density = lo.density + t * (hi.density - lo.density);
+    state.temperature = lo.temperature + t * (hi.temperature - lo.temperature);
+    state.speed_of_sound = lo.speed_of_sound + t * (hi.speed_of_sound - lo.speed_of_sound);
+    return state;
+}
@@ -0,0 +1,42 @@
+#ifndef __ISAATMOSPHERE_H__
+#define __ISAATMOSPHERE_H__
+
+#include <stddef.h>
+#include <vector>
+
+// Table bounds and resolution (m); linear interpolation error on pressure stays below 0.02 Pa
+#define ISA_TABLE_MIN_ALT -1000.0
+#define ISA_TABLE_MAX_ALT 32000.0
+#define ISA_TABLE_STEP 10.0
+
+struct AtmosphereState {
+    double pressure;        // Pa
+    double density;         // kg/m**3
+    double temperature;     // K
+    double speed_of_sound;  // m/s
+};
+
+/**
+ * International Standard Atmosphere up to 32 km (troposphere, tropopause and
+ * lower stratosphere), tabulated once and linearly interpolated.
+ *
+ * Altitudes outside the table are clamped to its bounds.
+ * The table is immutable after construction and can be shared freely.
+ */
+class ISAAtmosphere {
+private:
+    std::vector<AtmosphereState> table;
+    double inv_step;
+public:
+    ISAAtmosphere();
+    ISAAtmosphere(ISAAtmosphere& a) = delete;
+
+    static const ISAAtmosphere& shared_instance();
+
+    // Closed form ISA at the given altitude (m), as used to fill the table
+    static AtmosphereState evaluate(double altitude_m);
+
+    AtmosphereState at(double altitude_m) const;
+};
+
+#endif // __ISAATMOSPHERE_H__
@@ -1,7 +1,9 @@
 #ifndef __APM_EXTENSION_H__
 #define __APM_EXTENSION_H__
 
+#include <utility>
 #include "../ForceModels/Aerodynamics.h"
+#include "../Helpers/json.hh"
 
 /**
  * 
@@ -39,8 +41,52 @@
  * - m_Cn_p
  * - m_Cn_r
  * If a term is missing default value should be 0
+ *
+ * In a vehicle file the same values are read from the "aero" object, keyed
+ * by the coefficient name without its m_ prefix, e.g. {"CL_0": 0.0867, "CL_alpha": 4.02}.
  */
 struct APM : public caelus_fdm::APM {
+    void update_from(const nlohmann::json& data) {
+        static const std::pair<const char*, double caelus_fdm::APM::*> coefficients[] = {
+            {"CD_0", &caelus_fdm::APM::m_CD_0},
+            {"CS_0", &caelus_fdm::APM::m_CS_0},
+            {"CL_0", &caelus_fdm::APM::m_CL_0},
+            {"Cl_0", &caelus_fdm::APM::m_Cl_0},
+            {"Cm_0", &caelus_fdm::APM::m_Cm_0},
+            {"Cn_0", &caelus_fdm::APM::m_Cn_0},
+            {"CD_alpha", &caelus_fdm::APM::m_CD_alpha},
+            {"CD_alpha2", &caelus_fdm::APM::m_CD_alpha2},
+            {"CD_beta", &caelus_fdm::APM::m_CD_beta},
+            {"CD_beta2", &caelus_fdm::APM::m_CD_beta2},
+            {"CD_q", &caelus_fdm::APM::m_CD_q},
+            {"CD_delta_e2", &caelus_fdm::APM::m_CD_delta_e2},
+            {"CL_alpha", &caelus_fdm::APM::m_CL_alpha},
+            {"CL_q", &caelus_fdm::APM::m_CL_q},
+            {"CL_delta_e", &caelus_fdm::APM::m_CL_delta_e},
+            {"CS_beta", &caelus_fdm::APM::m_CS_beta},
+            {"CS_p", &caelus_fdm::APM::m_CS_p},
+            {"CS_r", &caelus_fdm::APM::m_CS_r},
+            {"CS_delta_a", &caelus_fdm::APM::m_CS_delta_a},
+            {"CS_delta_r", &caelus_fdm::APM::m_CS_delta_r},
+            {"Cl_beta", &caelus_fdm::APM::m_Cl_beta},
+            {"Cl_p", &caelus_fdm::APM::m_Cl_p},
+            {"Cl_r", &caelus_fdm::APM::m_Cl_r},
+            {"Cl_delta_a", &caelus_fdm::APM::m_Cl_delta_a},
+            {"Cl_delta_r", &caelus_fdm::APM::m_Cl_delta_r},
+            {"Cm_alpha", &caelus_fdm::APM::m_Cm_alpha},
+            {"Cm_delta_e", &caelus_fdm::APM::m_Cm_delta_e},
+            {"Cm_q", &caelus_fdm::APM::m_Cm_q},
+            {"Cn_beta", &caelus_fdm::APM::m_Cn_beta},
+            {"Cn_p", &caelus_fdm::APM::m_Cn_p},
+            {"Cn_r", &caelus_fdm::APM::m_Cn_r},
+            {"Cn_delta_a", &caelus_fdm::APM::m_Cn_delta_a},
+            {"Cn_delta_r", &caelus_fdm::APM::m_Cn_delta_r}
+        };
+        for (const auto& coefficient : coefficients) {
+            this->*coefficient.second = data.value(coefficient.first, this->*coefficient.second);
+        }
+    }
+
     friend std::istream &operator>>(std::istream &i, caelus_fdm::APM& aero_data) {
         i >> 
             aero_data.m_CL_0 >> // !
@@ -6,13 +6,15 @@
 
 class Aerodynamics : public caelus_fdm::Aerodynamics {
 public:
-    Aerodynamics(DroneConfig conf) : caelus_fdm::Aerodynamics(
+    Aerodynamics(const DroneConfig& conf) : caelus_fdm::Aerodynamics(
         conf.c,
-        conf.thruster_klift,
+        conf.b_aero,
         conf.S,
         conf.drone_aero_config,
         NULL
-    ) {};
+    ) {
+        this->setCoefficientTable(conf.aero_table);
+    };
 };
 
 #endif // __AERODYNAMICS_EXTENSION_H__
\ No newline at end of file
@@ -6,6 +6,8 @@
 
 /**
  * Eigen::MatrixXd extension to allow population by json.
+ * The diagonal (jxx, jyy, jzz) is required, the off-diagonal entries
+ * (jxy, jxz, jyz) are optional and mirrored (J is symmetric).
  */
 struct Matrix3d : public Eigen::Matrix3d {
     Matrix3d(nlohmann::json data) {
@@ -19,6 +21,9 @@ struct Matrix3d : public Eigen::Matrix3d {
         this->row(0)[0] = data["jxx"];
         this->row(1)[1] = data["jyy"];
         this->row(2)[2] = data["jzz"];
+        this->row(0)[1] = this->row(1)[0] = data.value("jxy", 0.0);
+        this->row(0)[2] = this->row(2)[0] = data.value("jxz", 0.0);
+        this->row(1)[2] = this->row(2)[1] = data.value("jyz", 0.0);
         printf("Inertia matrix initialised:\n");
         std::cout << *this << std::endl;
     }
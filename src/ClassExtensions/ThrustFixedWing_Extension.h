@@ -6,7 +6,7 @@
 
 class ThrustFixedWing : public caelus_fdm::ThrustFixedWing {
 public:
-    ThrustFixedWing(DroneConfig conf) : caelus_fdm::ThrustFixedWing(
+    ThrustFixedWing(const DroneConfig& conf) : caelus_fdm::ThrustFixedWing(
         conf.thruster_klift,
         NULL
     ) {};
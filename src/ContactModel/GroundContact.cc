@@ -0,0 +1,47 @@
+#include <algorithm>
+#include "GroundContact.h"
+
+bool GroundContact::add_forces(
+    const Eigen::VectorXd& state,
+    const Eigen::Matrix3d& body2earth,
+    const Terrain& terrain,
+    Eigen::Vector3d& force,
+    Eigen::Vector3d& moment) const {
+
+    const Eigen::Vector3d position = state.segment<3>(0);
+    const Eigen::Vector3d body_velocity = state.segment<3>(3);
+    const Eigen::Vector3d body_rates = state.segment<3>(9);
+    bool touching = false;
+
+    for (const Eigen::Vector3d& leg : this->config.points) {
+        Eigen::Vector3d leg_position = position + body2earth * leg;
+        double ground_down = -terrain.elevation_at(leg_position[0], leg_position[1]);
+        double penetration = leg_position[2] - ground_down;
+        if (penetration <= 0) continue;
+        touching = true;
+
+        // Earth frame velocity of the leg tip
+        Eigen::Vector3d leg_velocity = body2earth * (body_velocity + body_rates.cross(leg));
+        double normal = std::max(0.0, this->config.stiffness * penetration + this->config.damping * leg_velocity[2]);
+
+        // Coulomb friction, regularised below friction_velocity
+        Eigen::Vector3d slip{leg_velocity[0], leg_velocity[1], 0};
+        double slip_speed = std::max(slip.norm(), this->config.friction_velocity);
+        Eigen::Vector3d earth_force = -this->config.friction * normal * slip / slip_speed;
+        earth_force[2] -= normal;
+
+        Eigen::Vector3d body_force = body2earth.transpose() * earth_force;
+        force += body_force;
+        moment += leg.cross(body_force);
+    }
+    return touching;
+}
+
+double GroundContact::resting_down_position(double ground_down, double mass) const {
+    if (this->config.points.empty() || this->config.stiffness <= 0) return ground_down;
+    double lowest = this->config.points[0][2];
+    for (const Eigen::Vector3d& leg : this->config.points) lowest = std::max(lowest, leg[2]);
+    // Static compression with the weight shared by the legs
+    double compression = mass * G_FORCE / (this->config.points.size() * this->config.stiffness);
+    return ground_down - lowest + compression;
+}
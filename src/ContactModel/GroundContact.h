@@ -0,0 +1,41 @@
+#ifndef __GROUNDCONTACT_H__
+#define __GROUNDCONTACT_H__
+
+#include <Eigen/Eigen>
+#include "../Containers/LandingGearConfig.h"
+#include "../TerrainModel/Terrain.h"
+
+/**
+ * Spring-damper landing gear touching the terrain.
+ *
+ * Evaluated on the state of every integration stage, so that touchdowns are
+ * continuous forces seen by the integrator rather than state resets.
+ * The ground normal is taken vertical.
+ */
+class GroundContact {
+private:
+    LandingGearConfig config;
+public:
+    GroundContact(const LandingGearConfig& config) : config(config) {}
+
+    /**
+     * Adds the landing gear force and moment about the CG (Body Fixed) to `force` / `moment`.
+     * @param state         <x y z, u v w, phi theta psi, p q r> as in DynamicObject
+     * @param body2earth    rotation of `state`
+     * @return true when at least one leg touches the ground
+     */
+    bool add_forces(
+        const Eigen::VectorXd& state,
+        const Eigen::Matrix3d& body2earth,
+        const Terrain& terrain,
+        Eigen::Vector3d& force,
+        Eigen::Vector3d& moment) const;
+
+    /**
+     * NED down coordinate of the CG of a vehicle of `mass` (kg)
+     * resting level on the ground at `ground_down`.
+     */
+    double resting_down_position(double ground_down, double mass) const;
+};
+
+#endif // __GROUNDCONTACT_H__
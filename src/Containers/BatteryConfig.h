@@ -0,0 +1,43 @@
+#ifndef __BATTERYCONFIG_H__
+#define __BATTERYCONFIG_H__
+
+#include "../Helpers/json.hh"
+
+/**
+ * Battery pack and propulsion efficiency, read from the optional "battery"
+ * object of the vehicle file, e.g.
+ * "battery": {"cells": 4, "capacity_mah": 5000, "internal_resistance": 0.02, "status_rate_hz": 10}
+ */
+struct BatteryConfig {
+    int cells = 4;                          // LiPo cells in series
+    double capacity_mah = 5000;
+    double internal_resistance = 0.02;      // pack series resistance R0 (Ohm)
+    double polarization_resistance = 0.01;  // R1 (Ohm)
+    double polarization_capacitance = 2000; // C1 (F)
+    double avionics_current = 0.5;          // A
+    double temperature = 25;                // degC
+    double status_rate_hz = 10;             // BATTERY_STATUS rate
+
+    // Propulsion, from momentum theory
+    double propeller_diameter = 0.254;      // m
+    double figure_of_merit = 0.65;
+    double motor_efficiency = 0.8;          // motor and ESC
+
+    BatteryConfig() {}
+
+    void update_from(const nlohmann::json& data) {
+        this->cells = data.value("cells", this->cells);
+        this->capacity_mah = data.value("capacity_mah", this->capacity_mah);
+        this->internal_resistance = data.value("internal_resistance", this->internal_resistance);
+        this->polarization_resistance = data.value("polarization_resistance", this->polarization_resistance);
+        this->polarization_capacitance = data.value("polarization_capacitance", this->polarization_capacitance);
+        this->avionics_current = data.value("avionics_current", this->avionics_current);
+        this->temperature = data.value("temperature", this->temperature);
+        this->status_rate_hz = data.value("status_rate_hz", this->status_rate_hz);
+        this->propeller_diameter = data.value("propeller_diameter", this->propeller_diameter);
+        this->figure_of_merit = data.value("figure_of_merit", this->figure_of_merit);
+        this->motor_efficiency = data.value("motor_efficiency", this->motor_efficiency);
+    }
+};
+
+#endif // __BATTERYCONFIG_H__
@@ -0,0 +1,27 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "ConfigRegistry.h"
+
+ConfigRegistry& ConfigRegistry::shared_instance() {
+    static ConfigRegistry instance;
+    return instance;
+}
+
+std::shared_ptr<const DroneConfig> ConfigRegistry::get(const std::string& path) {
+    // "../drone_models/small" and "drone_models/small" are the same file
+    char resolved[PATH_MAX];
+    std::string key = realpath(path.c_str(), resolved) != NULL ? std::string(resolved) : path;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->configs.find(key);
+    if (it != this->configs.end()) return it->second;
+
+    std::shared_ptr<const DroneConfig> config = std::make_shared<const DroneConfig>(config_from_file_path(path.c_str()));
+    this->configs[key] = config;
+    return config;
+}
+
+void ConfigRegistry::clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->configs.clear();
+}
@@ -0,0 +1,34 @@
+#ifndef __CONFIGREGISTRY_H__
+#define __CONFIGREGISTRY_H__
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "DroneConfig.h"
+
+/**
+ * Vehicle configs shared by the whole process: each file is parsed and
+ * validated once, every vehicle built from it holds the same immutable copy.
+ */
+class ConfigRegistry {
+private:
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const DroneConfig>> configs;
+
+    ConfigRegistry() {};
+public:
+    static ConfigRegistry& shared_instance();
+    ConfigRegistry(ConfigRegistry& r) = delete;
+
+    /**
+     * Config of the vehicle file at `path`, parsed on first use.
+     * @throws ConfigError when the file is missing, is not JSON or lacks a required key
+     */
+    std::shared_ptr<const DroneConfig> get(const std::string& path);
+
+    // Forgets the parsed files: later calls to get() read them again
+    void clear();
+};
+
+#endif // __CONFIGREGISTRY_H__
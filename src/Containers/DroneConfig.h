@@ -1,13 +1,25 @@
 #ifndef __DRONECONFIG_H__
 #define __DRONECONFIG_H__
 
+#include <limits.h>
+#include <stdlib.h>
 #include <iostream>
 #include <istream>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <Eigen/Eigen>
 #include "../Interfaces/PrettyPrintable.h"
 #include "../ClassExtensions/Matrix3d_Extension.h"
 #include "../ClassExtensions/APM_Extension.h"
+#include "SensorsConfig.h"
+#include "LandingGearConfig.h"
+#include "BatteryConfig.h"
+#include "RotorConfig.h"
+#include "PX4Params.h"
+#include "../AeroModel/AeroCoefficientTable.h"
 #include "../Helpers/json.hh"
 
 /**
@@ -18,12 +30,17 @@
  * - mass
  * - thrust coefficient
  * - d
- * - c
- * - S
- * - b_aero
- * - drone_aero_config (see @ClassExtensions/APM_Extension)
+ * - c, S, b_aero, optional
+ * - aero, optional: drone_aero_config (see @ClassExtensions/APM_Extension)
+ * - aero_table, optional: binary coefficient table replacing the static aero derivatives (see @AeroModel/AeroCoefficientTable)
+ * - rotors, optional: VTOL rotor layout, PX4 quad X of arm vtol_lcog by default (see @Containers/RotorConfig)
  * - J (see @ClassExtensions/MatrixXd_Extension)
+ * - sensors, optional (see @Containers/SensorsConfig)
+ * - landing_gear, optional (see @Containers/LandingGearConfig)
+ * - battery, optional (see @Containers/BatteryConfig)
+ * - px4_params, optional: PX4 parameter file seeding the keys above (see @Containers/PX4Params)
  * 
+ * Vehicles share a parsed config through ConfigRegistry (see @Containers/ConfigRegistry).
  */
 struct DroneConfig : public PrettyPrintable {
     double mass = 0; // kg
@@ -42,11 +59,27 @@ struct DroneConfig : public PrettyPrintable {
     double thruster_lcog = 0;
     double thruster_tdrag = 0;
 
-    double c = 0; // ? 
-    double S = 0; // ?
-    double b_aero = 0; // ?
+    double c = 0; // mean aerodynamic chord (m)
+    double S = 0; // wing area (m**2)
+    double b_aero = 0; // wing span (m)
     APM drone_aero_config;
+    std::shared_ptr<const AeroCoefficientTable> aero_table; // loaded by config_from_file_path, NULL without one
+    std::vector<RotorConfig> rotors; // VTOL rotors
     Matrix3d J; // Inertial matrix
+    SensorsConfig sensors;
+    LandingGearConfig landing_gear;
+    BatteryConfig battery;
+
+    // Numeric keys every vehicle file must define
+    static const std::vector<std::string>& required_keys() {
+        static const std::vector<std::string> keys = {
+            "mass",
+            "vtol_komega", "vtol_kv", "vtol_klift", "vtol_tau", "vtol_lcog", "vtol_tdrag",
+            "thruster_komega", "thruster_kv", "thruster_klift", "thruster_tau", "thruster_lcog", "thruster_tdrag",
+            "jxx", "jyy", "jzz"
+        };
+        return keys;
+    }
 
     DroneConfig(nlohmann::json data) : J(data) {
         mass = data["mass"];
@@ -62,6 +95,16 @@ struct DroneConfig : public PrettyPrintable {
         thruster_tau = data["thruster_tau"];
         thruster_lcog = data["thruster_lcog"];
         thruster_tdrag = data["thruster_tdrag"];
+        c = data.value("c", c);
+        S = data.value("S", S);
+        b_aero = data.value("b_aero", b_aero);
+        if (data.find("aero") != data.end()) drone_aero_config.update_from(data["aero"]);
+        if (data.find("rotors") != data.end()) rotors = rotors_from(data["rotors"], vtol_komega);
+        else rotors = quad_x_rotors(vtol_lcog, vtol_komega);
+        if (data.find("sensors") != data.end()) sensors = SensorsConfig(data["sensors"]);
+        landing_gear = LandingGearConfig(mass, vtol_lcog);
+        if (data.find("landing_gear") != data.end()) landing_gear.update_from(data["landing_gear"]);
+        if (data.find("battery") != data.end()) battery.update_from(data["battery"]);
     }
 
     std::string str() override {
@@ -73,10 +116,146 @@ struct DroneConfig : public PrettyPrintable {
     }
 };
 
+// HIL_ACTUATOR_CONTROLS channels a rotor can be driven by
+#define DRONE_CONFIG_ACTUATOR_OUTPUTS 16
+
+// CBOR self-describe tag: marks a compiled vehicle file (see tools/config_compile)
+#define DRONE_CONFIG_COMPILED_MAGIC "\xd9\xd9\xf7"
+#define DRONE_CONFIG_COMPILED_MAGIC_SIZE 3
+
+/**
+ * Vehicle file that cannot be used, the message names the file and every problem found.
+ */
+struct ConfigError : public std::runtime_error {
+    ConfigError(const std::string& path, const std::string& problem) :
+        std::runtime_error("Invalid vehicle config " + path + ": " + problem) {}
+};
+
+/**
+ * Vehicle file as a JSON document, text or compiled.
+ * @throws ConfigError when the file is missing or cannot be decoded
+ */
+static nlohmann::json read_config_file(const char* path) {
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin) throw ConfigError(path, "cannot open file");
+    std::string contents((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+    nlohmann::json data;
+    if (contents.compare(0, DRONE_CONFIG_COMPILED_MAGIC_SIZE, DRONE_CONFIG_COMPILED_MAGIC) == 0) {
+        data = nlohmann::json::from_cbor(contents, true, false, nlohmann::json::cbor_tag_handler_t::ignore);
+    } else {
+        data = nlohmann::json::parse(contents, nullptr, false);
+    }
+    if (data.is_discarded() || !data.is_object()) throw ConfigError(path, "not a JSON object");
+    return data;
+}
+
+// `file` as referenced from the vehicle file at `vehicle_path`
+static std::string path_relative_to(const std::string& file, const char* vehicle_path) {
+    std::string vehicle_file = vehicle_path;
+    size_t directory_end = vehicle_file.find_last_of('/');
+    if (!file.empty() && file[0] != '/' && directory_end != std::string::npos) {
+        return vehicle_file.substr(0, directory_end + 1) + file;
+    }
+    return file;
+}
+
+/**
+ * Vehicle file with its PX4 parameters (if any) applied and the files it
+ * references resolved: the document the config is built from.
+ * @throws ConfigError when a file is missing or cannot be decoded
+ */
+static nlohmann::json resolve_config_file(const char* path) {
+    nlohmann::json data = read_config_file(path);
+
+    auto params_path = data.find("px4_params");
+    if (params_path != data.end() && params_path->is_string()) {
+        std::string params_file = path_relative_to(params_path->get<std::string>(), path);
+        PX4Params params;
+        if (!params.load(params_file.c_str())) throw ConfigError(path, "cannot open PX4 parameters " + params_file);
+        // The vehicle file wins over the parameters
+        nlohmann::json seeded = params.vehicle_config();
+        seeded.merge_patch(data);
+        data = seeded;
+        data.erase("px4_params");
+    }
+
+    auto table_path = data.find("aero_table");
+    if (table_path != data.end() && table_path->is_string()) {
+        // Absolute, so that a compiled copy of the file can live anywhere
+        std::string table_file = path_relative_to(table_path->get<std::string>(), path);
+        char resolved[PATH_MAX];
+        *table_path = realpath(table_file.c_str(), resolved) != NULL ? std::string(resolved) : table_file;
+    }
+    return data;
+}
+
+/**
+ * Parses and validates a vehicle file, JSON or compiled (see tools/config_compile).
+ * Prefer ConfigRegistry::get, which parses each file once per process.
+ * @throws ConfigError when a file is missing, cannot be decoded, lacks a required key or has a malformed value
+ */
 static DroneConfig config_from_file_path(const char* path) {
-    std::ifstream fin(path);
-    nlohmann::json data = nlohmann::json::parse(fin);
-    DroneConfig conf{data};
+    nlohmann::json data = resolve_config_file(path);
+
+    std::string problems;
+    for (const auto& key : DroneConfig::required_keys()) {
+        auto it = data.find(key);
+        if (it == data.end()) problems += (problems.empty() ? "" : ", ") + ("missing \"" + key + "\"");
+        else if (!it->is_number()) problems += (problems.empty() ? "" : ", ") + ("\"" + key + "\" is not a number");
+    }
+    auto rotors = data.find("rotors");
+    if (rotors != data.end() && (!rotors->is_array() || rotors->empty())) {
+        problems += (problems.empty() ? "" : ", ") + std::string("\"rotors\" is not a non-empty array");
+    } else if (rotors != data.end()) {
+        auto is_vector3 = [](const nlohmann::json& v) {
+            return v.is_array() && v.size() == 3 && v[0].is_number() && v[1].is_number() && v[2].is_number();
+        };
+        for (size_t i = 0; i < rotors->size(); i++) {
+            const nlohmann::json& rotor = (*rotors)[i];
+            std::string name = "rotor " + std::to_string(i);
+            if (!rotor.is_object()) {
+                problems += (problems.empty() ? "" : ", ") + (name + " is not an object");
+                continue;
+            }
+            auto output = rotor.find("output");
+            if (output != rotor.end() && !output->is_number_integer()) {
+                problems += (problems.empty() ? "" : ", ") + (name + " output is not an integer");
+            } else {
+                int channel = output != rotor.end() ? output->get<int>() : (int)i;
+                if (channel < 0 || channel >= DRONE_CONFIG_ACTUATOR_OUTPUTS)
+                    problems += (problems.empty() ? "" : ", ") + (name + " drives no actuator output");
+            }
+            auto position = rotor.find("position");
+            if (position != rotor.end() && !is_vector3(*position))
+                problems += (problems.empty() ? "" : ", ") + (name + " position is not 3 numbers");
+            auto axis = rotor.find("axis");
+            if (axis != rotor.end() && !is_vector3(*axis)) {
+                problems += (problems.empty() ? "" : ", ") + (name + " axis is not 3 numbers");
+            } else if (axis != rotor.end() && (*axis)[0] == 0 && (*axis)[1] == 0 && (*axis)[2] == 0) {
+                problems += (problems.empty() ? "" : ", ") + (name + " axis is zero");
+            }
+        }
+    }
+    auto table_path = data.find("aero_table");
+    if (table_path != data.end() && !table_path->is_string()) {
+        problems += (problems.empty() ? "" : ", ") + std::string("\"aero_table\" is not a file name");
+    }
+    if (!problems.empty()) throw ConfigError(path, problems);
+
+    // Optional objects are only checked while they are read
+    DroneConfig conf = [&] {
+        try {
+            return DroneConfig{data};
+        } catch (const nlohmann::json::exception& e) {
+            throw ConfigError(path, e.what());
+        }
+    }();
+    if (table_path != data.end()) {
+        auto table = std::make_shared<AeroCoefficientTable>(table_path->get<std::string>().c_str());
+        if (!table->is_loaded()) throw ConfigError(path, "cannot load aero table " + table_path->get<std::string>());
+        conf.aero_table = table;
+    }
     return conf;
 }
 
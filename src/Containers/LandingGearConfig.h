@@ -0,0 +1,53 @@
+#ifndef __LANDINGGEARCONFIG_H__
+#define __LANDINGGEARCONFIG_H__
+
+#include <cmath>
+#include <vector>
+#include <Eigen/Eigen>
+#include "../Helpers/json.hh"
+#include "../Helpers/constants.h"
+
+// Default static compression of each leg and damping ratio
+#define LANDING_GEAR_STATIC_COMPRESSION 0.01 // m
+#define LANDING_GEAR_DAMPING_RATIO 0.7
+
+/**
+ * Spring-damper landing gear, read from the optional "landing_gear" object
+ * of the vehicle file, e.g.
+ * "landing_gear": {"points": [[0.2, 0.2, 0.1], ...], "stiffness": 350, "damping": 15, "friction": 0.5}
+ *
+ * Without one, four legs sit under the rotor arms, stiff enough to sag by
+ * LANDING_GEAR_STATIC_COMPRESSION under the vehicle weight.
+ */
+struct LandingGearConfig {
+    std::vector<Eigen::Vector3d> points;   // contact points (Body Fixed) (m)
+    double stiffness = 0;                  // per leg (N/m)
+    double damping = 0;                    // per leg (N s/m)
+    double friction = 0.5;                 // Coulomb friction coefficient
+    double friction_velocity = 0.1;        // slip velocity of full friction (m/s)
+
+    LandingGearConfig() {}
+    LandingGearConfig(double mass, double arm_length) {
+        double offset = 0.7 * arm_length;
+        for (int i = 0; i < 4; i++) {
+            this->points.push_back(Eigen::Vector3d{i < 2 ? offset : -offset, i % 2 ? offset : -offset, 0.1});
+        }
+        double leg_mass = mass / this->points.size();
+        this->stiffness = leg_mass * G_FORCE / LANDING_GEAR_STATIC_COMPRESSION;
+        this->damping = 2 * LANDING_GEAR_DAMPING_RATIO * std::sqrt(this->stiffness * leg_mass);
+    }
+
+    void update_from(const nlohmann::json& data) {
+        auto it = data.find("points");
+        if (it != data.end()) {
+            this->points.clear();
+            for (const auto& p : *it) this->points.push_back(Eigen::Vector3d{p[0].get<double>(), p[1].get<double>(), p[2].get<double>()});
+        }
+        this->stiffness = data.value("stiffness", this->stiffness);
+        this->damping = data.value("damping", this->damping);
+        this->friction = data.value("friction", this->friction);
+        this->friction_velocity = data.value("friction_velocity", this->friction_velocity);
+    }
+};
+
+#endif // __LANDINGGEARCONFIG_H__
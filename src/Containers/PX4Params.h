@@ -0,0 +1,111 @@
+#ifndef __PX4PARAMS_H__
+#define __PX4PARAMS_H__
+
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include "../Helpers/json.hh"
+
+/**
+ * PX4 parameters read from either:
+ * - a QGroundControl / PX4 parameter dump (.params):
+ *   `<vehicle id> <component id> <name> <value> <type>` per line, # comments
+ * - an airframe script: `param set <name> <value>` lines, others ignored
+ *
+ * Used to seed a vehicle file with the parameters the autopilot runs with
+ * (see vehicle_config), so that the simulated sensors match its rates.
+ */
+class PX4Params {
+private:
+    std::map<std::string, double> values;
+
+public:
+    /**
+     * @return false when the file cannot be read, the lines that are not
+     * parameters are skipped, a parameter set twice keeps its last value
+     */
+    bool load(const char* path) {
+        std::ifstream fin(path);
+        if (!fin) return false;
+        std::string line;
+        while (std::getline(fin, line)) {
+            std::istringstream fields(line);
+            std::string first, name;
+            double value;
+            if (!(fields >> first) || first[0] == '#') continue;
+            if (first == "param") {
+                std::string verb;
+                if (fields >> verb >> name >> value && verb == "set") this->values[name] = value;
+            } else {
+                std::string component;
+                if (fields >> component >> name >> value) this->values[name] = value;
+            }
+        }
+        return true;
+    }
+
+    size_t size() const { return this->values.size(); }
+    bool has(const std::string& name) const { return this->values.find(name) != this->values.end(); }
+    double get(const std::string& name, double default_value = 0) const {
+        auto it = this->values.find(name);
+        return it != this->values.end() ? it->second : default_value;
+    }
+
+    /**
+     * Vehicle file keys implied by the parameters (PX4 units converted):
+     * - IMU_INTEG_RATE, capped by IMU_GYRO_RATEMAX: sensors.imu_rate_hz (HIL_SENSOR rate)
+     * - SENS_BARO_RATE, SENS_MAG_RATE: barometer / magnetometer rate_hz
+     * - EKF2_GPS_DELAY, EKF2_BARO_DELAY, EKF2_MAG_DELAY (ms): sensor delay_ms
+     * - BAT1_N_CELLS (BAT_N_CELLS before PX4 1.13), BAT1_CAPACITY, BAT1_R_INTERNAL: battery
+     * - CA_ROTOR_COUNT, CA_ROTOR<i>_PX / _PY: vtol_lcog, mean rotor arm (m)
+     * - CA_ROTOR<i>_PX / _PY / _PZ, _AX / _AY / _AZ, _KM sign: rotors, rotor i on output i
+     * Unset PX4 values (-1, 0 where PX4 means "disabled") are left out.
+     */
+    nlohmann::json vehicle_config() const {
+        nlohmann::json config = nlohmann::json::object();
+        nlohmann::json& sensors = config["sensors"] = nlohmann::json::object();
+        nlohmann::json& battery = config["battery"] = nlohmann::json::object();
+
+        double imu_rate = this->get("IMU_INTEG_RATE");
+        double gyro_rate_max = this->get("IMU_GYRO_RATEMAX");
+        if (gyro_rate_max > 0 && (imu_rate <= 0 || gyro_rate_max < imu_rate)) imu_rate = gyro_rate_max;
+        if (imu_rate > 0) sensors["imu_rate_hz"] = imu_rate;
+
+        if (this->get("SENS_BARO_RATE") > 0) sensors["barometer"]["rate_hz"] = this->get("SENS_BARO_RATE");
+        if (this->get("SENS_MAG_RATE") > 0) sensors["magnetometer"]["rate_hz"] = this->get("SENS_MAG_RATE");
+        if (this->get("EKF2_GPS_DELAY") > 0) {
+            sensors["gps_position"]["delay_ms"] = this->get("EKF2_GPS_DELAY");
+            sensors["gps_velocity"]["delay_ms"] = this->get("EKF2_GPS_DELAY");
+        }
+        if (this->get("EKF2_BARO_DELAY") > 0) sensors["barometer"]["delay_ms"] = this->get("EKF2_BARO_DELAY");
+        if (this->get("EKF2_MAG_DELAY") > 0) sensors["magnetometer"]["delay_ms"] = this->get("EKF2_MAG_DELAY");
+
+        double cells = this->has("BAT1_N_CELLS") ? this->get("BAT1_N_CELLS") : this->get("BAT_N_CELLS");
+        if (cells > 0) battery["cells"] = (int)cells;
+        if (this->get("BAT1_CAPACITY", -1) > 0) battery["capacity_mah"] = this->get("BAT1_CAPACITY");
+        if (this->get("BAT1_R_INTERNAL", -1) > 0) battery["internal_resistance"] = this->get("BAT1_R_INTERNAL");
+
+        int rotors = (int)this->get("CA_ROTOR_COUNT");
+        double arms = 0;
+        for (int i = 0; i < rotors; i++) {
+            std::string rotor = "CA_ROTOR" + std::to_string(i);
+            arms += std::hypot(this->get(rotor + "_PX"), this->get(rotor + "_PY"));
+        }
+        if (rotors > 0 && arms > 0) config["vtol_lcog"] = arms / rotors;
+        for (int i = 0; i < rotors && arms > 0; i++) {
+            std::string rotor = "CA_ROTOR" + std::to_string(i);
+            nlohmann::json& entry = config["rotors"][i];
+            entry["position"] = {this->get(rotor + "_PX"), this->get(rotor + "_PY"), this->get(rotor + "_PZ")};
+            // PX4 defaults to an upward axis and counter-clockwise (positive moment coefficient) rotors
+            entry["axis"] = {this->get(rotor + "_AX"), this->get(rotor + "_AY"), this->get(rotor + "_AZ", -1)};
+            entry["direction"] = this->get(rotor + "_KM", 0.05) < 0 ? "cw" : "ccw";
+            entry["output"] = i;
+        }
+
+        return config;
+    }
+};
+
+#endif // __PX4PARAMS_H__
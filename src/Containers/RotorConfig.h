@@ -0,0 +1,75 @@
+#ifndef __ROTORCONFIG_H__
+#define __ROTORCONFIG_H__
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <Eigen/Eigen>
+#include "../Helpers/json.hh"
+
+/**
+ * One VTOL rotor, read from the optional "rotors" array of the vehicle file, e.g.
+ * "rotors": [{"position": [0.12, 0.12, 0], "direction": "ccw", "output": 0}, ...]
+ *
+ * Its thrust k_f * w**2 acts along `axis` at `position`, its reaction torque
+ * (k_m * w**2 + vtol_tdrag * w) acts about -axis for a counter-clockwise rotor
+ * (seen from above) and about +axis for a clockwise one.
+ */
+struct RotorConfig {
+    Eigen::Vector3d position{0, 0, 0};     // (Body Fixed) (m)
+    Eigen::Vector3d axis{0, 0, -1};        // thrust direction (Body Fixed), unit
+    int direction = 1;                     // 1: counter-clockwise, -1: clockwise
+    int output = 0;                        // HIL_ACTUATOR_CONTROLS channel driving it
+    double thrust_coefficient = 0;         // k_f (N/(rad/s)**2)
+    double torque_coefficient = 0;         // k_m (N m/(rad/s)**2)
+
+    RotorConfig() {}
+    RotorConfig(const Eigen::Vector3d& position, int direction, int output, double thrust_coefficient) :
+        position(position), direction(direction), output(output), thrust_coefficient(thrust_coefficient) {}
+
+    void update_from(const nlohmann::json& data) {
+        auto it = data.find("position");
+        if (it != data.end()) this->position = Eigen::Vector3d{(*it)[0].get<double>(), (*it)[1].get<double>(), (*it)[2].get<double>()};
+        it = data.find("axis");
+        if (it != data.end()) this->axis = Eigen::Vector3d{(*it)[0].get<double>(), (*it)[1].get<double>(), (*it)[2].get<double>()}.normalized();
+        it = data.find("direction");
+        if (it != data.end() && it->is_string()) this->direction = it->get<std::string>() == "cw" ? -1 : 1;
+        else if (it != data.end()) this->direction = it->get<double>() < 0 ? -1 : 1;
+        this->output = data.value("output", this->output);
+        this->thrust_coefficient = data.value("thrust_coefficient", this->thrust_coefficient);
+        this->torque_coefficient = data.value("torque_coefficient", this->torque_coefficient);
+    }
+};
+
+/**
+ * PX4 quad X (outputs 0: front right, 1: rear left, 2: front left, 3: rear right),
+ * rotors ordered front right, rear right, rear left, front left.
+ * @param arm_length distance of each rotor from the centre of gravity (m)
+ */
+static std::vector<RotorConfig> quad_x_rotors(double arm_length, double thrust_coefficient) {
+    double a = arm_length * std::sqrt(2) / 2;
+    return {
+        RotorConfig(Eigen::Vector3d{a, a, 0}, 1, 0, thrust_coefficient),
+        RotorConfig(Eigen::Vector3d{-a, a, 0}, -1, 3, thrust_coefficient),
+        RotorConfig(Eigen::Vector3d{-a, -a, 0}, 1, 1, thrust_coefficient),
+        RotorConfig(Eigen::Vector3d{a, -a, 0}, -1, 2, thrust_coefficient),
+    };
+}
+
+/**
+ * Rotors of a "rotors" array, the thrust coefficient defaults to `thrust_coefficient`
+ * and the output to the rotor index.
+ */
+static std::vector<RotorConfig> rotors_from(const nlohmann::json& data, double thrust_coefficient) {
+    std::vector<RotorConfig> rotors;
+    for (size_t i = 0; i < data.size(); i++) {
+        RotorConfig rotor;
+        rotor.output = (int)i;
+        rotor.thrust_coefficient = thrust_coefficient;
+        rotor.update_from(data[i]);
+        rotors.push_back(rotor);
+    }
+    return rotors;
+}
+
+#endif // __ROTORCONFIG_H__
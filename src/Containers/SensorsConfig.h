@@ -0,0 +1,73 @@
+#ifndef __SENSORSCONFIG_H__
+#define __SENSORSCONFIG_H__
+
+#include "../Helpers/json.hh"
+
+/**
+ * Error model of a single sensor, in the units of its output.
+ * JSON keys (all optional): rate_hz, delay_ms, noise, bias_walk,
+ * bias_correlation_time, scale, vibration_amplitude, vibration_frequency_hz
+ */
+struct SensorConfig {
+    double rate_hz = 0;                 // 0: sampled every tick
+    double delay = 0;                   // transport delay (s)
+    double noise = 0;                   // white noise standard deviation
+    double bias_walk = 0;               // bias random walk (units / sqrt(s))
+    double bias_correlation_time = 0;   // Gauss-Markov time constant (s), 0: unbounded walk
+    double scale = 1;                   // scale factor
+    double vibration_amplitude = 0;
+    double vibration_frequency = 0;     // Hz
+
+    SensorConfig() {}
+    SensorConfig(double noise, double bias_walk = 0, double bias_correlation_time = 0) :
+        noise(noise), bias_walk(bias_walk), bias_correlation_time(bias_correlation_time) {}
+
+    void update_from(const nlohmann::json& data) {
+        this->rate_hz = data.value("rate_hz", this->rate_hz);
+        this->delay = data.value("delay_ms", this->delay * 1000.0) / 1000.0;
+        this->noise = data.value("noise", this->noise);
+        this->bias_walk = data.value("bias_walk", this->bias_walk);
+        this->bias_correlation_time = data.value("bias_correlation_time", this->bias_correlation_time);
+        this->scale = data.value("scale", this->scale);
+        this->vibration_amplitude = data.value("vibration_amplitude", this->vibration_amplitude);
+        this->vibration_frequency = data.value("vibration_frequency_hz", this->vibration_frequency);
+    }
+};
+
+/**
+ * Error models of the simulated sensor suite, read from the optional
+ * "sensors" object of the vehicle file, e.g.
+ * "sensors": {"imu_rate_hz": 250, "gyroscope": {"noise": 0.003}, "gps_position": {"delay_ms": 100}}
+ */
+struct SensorsConfig {
+    // HIL sensor output rate, IMU samples are integrated in between (0: every physics step)
+    double imu_rate_hz = 0;
+    SensorConfig accelerometer{0.001};      // m/s**2
+    SensorConfig gyroscope{0.001};          // rad/s
+    SensorConfig magnetometer{0.000001};    // gauss
+    SensorConfig barometer{0.001};          // Pa
+    SensorConfig thermometer{0.001};        // degC
+    SensorConfig gps_position{0, 0.05, 30}; // NED (m)
+    SensorConfig gps_velocity{0.00001};     // NED (m/s)
+
+    SensorsConfig() {}
+    SensorsConfig(const nlohmann::json& data) {
+        if (!data.is_object()) return;
+        this->imu_rate_hz = data.value("imu_rate_hz", this->imu_rate_hz);
+        const std::pair<const char*, SensorConfig*> sensors[] = {
+            {"accelerometer", &this->accelerometer},
+            {"gyroscope", &this->gyroscope},
+            {"magnetometer", &this->magnetometer},
+            {"barometer", &this->barometer},
+            {"thermometer", &this->thermometer},
+            {"gps_position", &this->gps_position},
+            {"gps_velocity", &this->gps_velocity}
+        };
+        for (const auto& sensor : sensors) {
+            auto it = data.find(sensor.first);
+            if (it != data.end()) sensor.second->update_from(*it);
+        }
+    }
+};
+
+#endif // __SENSORSCONFIG_H__
@@ -1,23 +1,23 @@
 #include "SimpleFixedWingController.h"
 
 
-Eigen::VectorXd SimpleFixedWingController::none_controller(DroneConfig conf, boost::chrono::microseconds t) {
+Eigen::VectorXd SimpleFixedWingController::none_controller(const DroneConfig& conf, boost::chrono::microseconds t) {
     return Eigen::VectorXd::Zero(8);
 }
 
-Eigen::VectorXd SimpleFixedWingController::hold_controller(DroneConfig conf, boost::chrono::microseconds t) {
+Eigen::VectorXd SimpleFixedWingController::hold_controller(const DroneConfig& conf, boost::chrono::microseconds t) {
     Eigen::VectorXd control{8};
     for (auto i = 0; i < control.size(); i++) control[i] = 0.5;
     return control;
 }
 
-Eigen::VectorXd SimpleFixedWingController::climb_controller(DroneConfig conf, boost::chrono::microseconds t) {
+Eigen::VectorXd SimpleFixedWingController::climb_controller(const DroneConfig& conf, boost::chrono::microseconds t) {
     Eigen::VectorXd control{8};
     for (auto i = 0; i < control.size(); i++) control[i] = 0.6;
     return control;
 }
 
-Eigen::VectorXd SimpleFixedWingController::roll_controller(DroneConfig conf, boost::chrono::microseconds t) {
+Eigen::VectorXd SimpleFixedWingController::roll_controller(const DroneConfig& conf, boost::chrono::microseconds t) {
     Eigen::VectorXd control{8};
     control[0] = 0.4;
     control[1] = 0.6;
@@ -26,7 +26,7 @@ Eigen::VectorXd SimpleFixedWingController::roll_controller(DroneConfig conf, boo
     return control;
 }
 
-Eigen::VectorXd SimpleFixedWingController::pitch_controller(DroneConfig conf, boost::chrono::microseconds t) {
+Eigen::VectorXd SimpleFixedWingController::pitch_controller(const DroneConfig& conf, boost::chrono::microseconds t) {
     Eigen::VectorXd control{8};
     control[0] = 0.6;
     control[1] = 0.4;
@@ -35,7 +35,7 @@ Eigen::VectorXd SimpleFixedWingController::pitch_controller(DroneConfig conf, bo
     return control;
 }
 
-Eigen::VectorXd SimpleFixedWingController::yaw_controller(DroneConfig conf, boost::chrono::microseconds t) {
+Eigen::VectorXd SimpleFixedWingController::yaw_controller(const DroneConfig& conf, boost::chrono::microseconds t) {
     Eigen::VectorXd control{8};
     control[0] = 0.8;
     control[1] = 0.8;
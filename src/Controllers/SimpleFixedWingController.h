@@ -6,6 +6,7 @@
 #include "../Interfaces/TimeHandler.h"
 #include <Eigen/Eigen>
 #include <boost/chrono.hpp>
+#include <memory>
 #include <stdio.h>
 
 enum Manoeuvre { NONE, CLIMB, HOLD, ROLL, PITCH, YAW };
@@ -39,7 +40,7 @@ static const char* manouvre_name(Manoeuvre m) {
 
 class SimpleFixedWingController : public DroneController {
 protected: 
-    DroneConfig config;
+    std::shared_ptr<const DroneConfig> config;
 
     ManoeuvrePlan plan;
     bool executing_manoeuvre = false;
@@ -48,12 +49,12 @@ protected:
     boost::chrono::microseconds manoeuvre_timer_us{0};
     boost::chrono::microseconds total_timer_us{0};
 
-    static Eigen::VectorXd none_controller(DroneConfig conf, boost::chrono::microseconds t);
-    static Eigen::VectorXd hold_controller(DroneConfig conf, boost::chrono::microseconds t);
-    static Eigen::VectorXd climb_controller(DroneConfig conf, boost::chrono::microseconds t);
-    static Eigen::VectorXd roll_controller(DroneConfig conf, boost::chrono::microseconds t);
-    static Eigen::VectorXd pitch_controller(DroneConfig conf, boost::chrono::microseconds t);
-    static Eigen::VectorXd yaw_controller(DroneConfig conf, boost::chrono::microseconds t);
+    static Eigen::VectorXd none_controller(const DroneConfig& conf, boost::chrono::microseconds t);
+    static Eigen::VectorXd hold_controller(const DroneConfig& conf, boost::chrono::microseconds t);
+    static Eigen::VectorXd climb_controller(const DroneConfig& conf, boost::chrono::microseconds t);
+    static Eigen::VectorXd roll_controller(const DroneConfig& conf, boost::chrono::microseconds t);
+    static Eigen::VectorXd pitch_controller(const DroneConfig& conf, boost::chrono::microseconds t);
+    static Eigen::VectorXd yaw_controller(const DroneConfig& conf, boost::chrono::microseconds t);
 
     void transition_to_next_manouvre() {
 
@@ -72,7 +73,8 @@ protected:
     }
 
 public:
-    SimpleFixedWingController(DroneConfig config) : config(config) {};
+    SimpleFixedWingController(std::shared_ptr<const DroneConfig> config) : config(config) {};
+    SimpleFixedWingController(const DroneConfig& config) : config(std::make_shared<const DroneConfig>(config)) {};
 
     Manoeuvre get_current_manoeuvre() { return this->plan.manoeuvre[this->plan_cursor]; }
     boost::chrono::microseconds get_current_manoeuvre_duration() { return this->plan.section_length[this->plan_cursor]; }
@@ -84,7 +86,7 @@ public:
         return duration;
     }
 
-    auto controller_for_manoeuvre() -> Eigen::VectorXd(*)(DroneConfig, boost::chrono::microseconds) {
+    auto controller_for_manoeuvre() -> Eigen::VectorXd(*)(const DroneConfig&, boost::chrono::microseconds) {
         switch(this->get_current_manoeuvre()) {
             case Manoeuvre::NONE:
                 return &SimpleFixedWingController::none_controller;
@@ -118,7 +120,7 @@ public:
 
     Eigen::VectorXd get_current_pwm_control() {
         auto func = this->controller_for_manoeuvre();
-        return func(this->config, this->manoeuvre_timer_us);
+        return func(*this->config, this->manoeuvre_timer_us);
     }
     
     virtual Eigen::VectorXd control(double dt) override {
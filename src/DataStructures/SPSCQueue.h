@@ -0,0 +1,93 @@
+#ifndef __SPSCQUEUE_H__
+#define __SPSCQUEUE_H__
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CACHE_LINE_SIZE 64
+
+/**
+ * Bounded, lock-free, single-producer / single-consumer ring buffer.
+ *
+ * Meant for the network thread -> simulation thread hand-off of MAVLink frames:
+ * - push() must only be called by one thread, consume_all() by one (other) thread.
+ * - Capacity is rounded up to the next power of two (index wrap is a mask).
+ * - Producer and consumer indices live on separate cache lines to avoid false sharing.
+ * - A full queue rejects the new element and counts it as an overflow.
+ */
+template<typename T>
+class SPSCQueue {
+private:
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;
+    // Most elements found by a drain, written by the consumer only
+    std::atomic<size_t> high_water_mark{0};
+
+    // Producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+    std::atomic<uint64_t> overflows{0};
+
+    static size_t next_power_of_two(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+public:
+    explicit SPSCQueue(size_t requested_capacity) :
+        capacity(next_power_of_two(requested_capacity > 0 ? requested_capacity : 1)),
+        mask(capacity - 1),
+        slots(new T[capacity]) {}
+
+    SPSCQueue(SPSCQueue& q) = delete;
+
+    bool push(const T& element) {
+        size_t t = this->tail.load(std::memory_order_relaxed);
+        if (t - this->cached_head >= this->capacity) {
+            this->cached_head = this->head.load(std::memory_order_acquire);
+            if (t - this->cached_head >= this->capacity) {
+                this->overflows.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        this->slots[t & this->mask] = element;
+        this->tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pops every element available at call time, in FIFO order.
+     * @return number of consumed elements
+     */
+    template<typename Functor>
+    size_t consume_all(Functor f) {
+        size_t h = this->head.load(std::memory_order_relaxed);
+        this->cached_tail = this->tail.load(std::memory_order_acquire);
+        if (this->cached_tail - h > this->high_water_mark.load(std::memory_order_relaxed))
+            this->high_water_mark.store(this->cached_tail - h, std::memory_order_relaxed);
+        size_t consumed = 0;
+        while (h != this->cached_tail) {
+            f(this->slots[h & this->mask]);
+            this->head.store(++h, std::memory_order_release);
+            consumed++;
+        }
+        return consumed;
+    }
+
+    size_t get_capacity() const { return this->capacity; }
+    size_t size_approx() const {
+        return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+    }
+    uint64_t get_overflows() const { return this->overflows.load(std::memory_order_relaxed); }
+    size_t get_high_water_mark() const { return this->high_water_mark.load(std::memory_order_relaxed); }
+};
+
+#endif // __SPSCQUEUE_H__
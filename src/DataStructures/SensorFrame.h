@@ -0,0 +1,42 @@
+#ifndef __SENSORFRAME_H__
+#define __SENSORFRAME_H__
+
+#include <Eigen/Eigen>
+#include "LatLonAlt.h"
+#include "GPSData.h"
+
+/**
+ * Snapshot of every sensor quantity for one simulation tick.
+ * Sampled once per tick and shared by all the MAVLink message encoders,
+ * so that rotations and geodesy are not recomputed per message.
+ */
+struct SensorFrame {
+    // State
+    Eigen::Vector3d earth_position;     // NED (m)
+    Eigen::Vector3d body_velocity;      // m/s
+    Eigen::Vector3d earth_attitude;     // roll, pitch, yaw (rad)
+    Eigen::Vector3d body_gyro;          // rad/s
+    // Dx state
+    Eigen::Vector3d earth_velocity;     // NED (m/s)
+    Eigen::Vector3d body_acceleration;  // m/s**2
+    Eigen::Vector3d earth_angle_rates;  // rad/s
+    // Rotations
+    Eigen::Matrix3d body2earth;
+    Eigen::Matrix3d earth2body;
+    // Derived quantities
+    LatLonAlt lat_lon_alt;
+    Eigen::Vector3d magnetic_field;     // body frame (gauss)
+    Eigen::Vector3d ground_speed;       // m/s
+    double pressure;                    // Pa
+    double temperature;                 // degC
+    uint16_t true_wind_speed;
+    // Measurements, sensor error models applied
+    Eigen::Vector3d accelerometer;      // body frame specific force (m/s**2)
+    Eigen::Vector3d gyroscope;          // rad/s
+    Eigen::Vector3d magnetometer;       // body frame (gauss)
+    double barometer_pressure;          // Pa
+    double thermometer_temperature;     // degC
+    GPSData gps_data;
+};
+
+#endif // __SENSORFRAME_H__
@@ -2,46 +2,48 @@
 #include "Drone.h"
 #include "DroneSensors.h"
 #include "Logging/ConsoleLogger.h"
-#include "Helpers/rotationMatrix.h"
+#include "Profiling/TickProfiler.h"
+#include "Profiling/TraceRecorder.h"
 
 // #define HIL_ACTUATOR_CONTROLS_VERBOSE
+// #define MAVLINK_ROUTING_VERBOSE
 
-Drone::Drone(const char* config_file, MAVLinkMessageRelay& connection, Clock& clock) : 
+#ifdef MAVLINK_ROUTING_VERBOSE
+#define ROUTING_LOG(s) ConsoleLogger::shared_instance()->debug_log(s)
+#else
+#define ROUTING_LOG(s)
+#endif
+
+Drone::Drone(const char* config_file, MAVLinkMessageRelay& connection, Clock& clock, size_t inbound_queue_capacity) : 
+    Drone(ConfigRegistry::shared_instance().get(config_file), connection, clock, inbound_queue_capacity) {}
+
+Drone::Drone(std::shared_ptr<const DroneConfig> config, MAVLinkMessageRelay& connection, Clock& clock, size_t inbound_queue_capacity) : 
     MAVLinkSystem::MAVLinkSystem(1, 1),
-    DynamicObject::DynamicObject(config_from_file_path(config_file), clock),
-    config(config_from_file_path(config_file)),
-    connection(connection)
+    DynamicObject::DynamicObject(config, clock),
+    connection(connection),
+    message_queue(inbound_queue_capacity),
+    queue_depth_metric(MetricsRegistry::shared_instance().gauge("sim6dof_queue_depth", "Inbound MAVLink frames found by the last drain", "queue=\"drone\"")),
+    queue_dropped_metric(MetricsRegistry::shared_instance().counter("sim6dof_queue_dropped_frames_total", "Inbound MAVLink frames dropped on a full queue", "queue=\"drone\""))
     {
-        this->connection.add_message_handler(this);
+        // Only the messages the drone acts upon are routed to it
+        this->connection.add_message_handler(this, MAVLINK_MSG_ID_HEARTBEAT);
+        this->connection.add_message_handler(this, MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS);
+        this->connection.add_message_handler(this, MAVLINK_MSG_ID_COMMAND_LONG);
         this->_setup_drone();
     }
 
 void Drone::_setup_drone() {
     // Inject controllers into dynamics model
-    this->setControllerVTOL([this] (double dt) -> Eigen::VectorXd
-        { return this->virtual_esc.control(dt).segment(0,4); });
-    this->setControllerThrust([this] (double dt) -> Eigen::VectorXd
-        { return this->virtual_esc.control(dt).segment(4,2); });
-    this->setControllerAero([this] (double dt) -> Eigen::VectorXd
-        { return this->virtual_esc.control(dt).segment(6,2); });
-}
-
-void Drone::fake_ground_transform(boost::chrono::microseconds us) {
-    double dt = (us.count() / 1000000.0);
-    Eigen::Vector3d position = this->get_sensors().get_earth_frame_position(); // NED
-    Eigen::Vector3d velocity = this->get_sensors().get_earth_frame_velocity(); // NED
-    Eigen::Vector3d acceleration = caelus_fdm::body2earth(this->state) * this->get_sensors().get_body_frame_acceleration();
-
-    if (position[2] >= this->ground_height && acceleration[2] * dt + velocity[2] >= 0) {
-        this->state[2] = 0;
-        // Body frame velocity
-        this->state.segment(3, 3) = Eigen::VectorXd::Zero(3);
-        // Rotation rate
-        this->state.segment(9, 3) = Eigen::VectorXd::Zero(3);
-        // Orientation
-        this->state.segment(6, 3) = Eigen::VectorXd::Zero(3);
-    }
+    // ESC controls are [rotors, thrust propeller (2), elevons (2)]
+    const int rotors = this->config.rotors.size();
+    this->setControllerVTOL([this, rotors] (double dt) -> Eigen::VectorXd
+        { return this->virtual_esc.control(dt).segment(0,rotors); });
+    this->setControllerThrust([this, rotors] (double dt) -> Eigen::VectorXd
+        { return this->virtual_esc.control(dt).segment(rotors,2); });
+    this->setControllerAero([this, rotors] (double dt) -> Eigen::VectorXd
+        { return this->virtual_esc.control(dt).segment(rotors+2,2); });
 }
+
 void Drone::update(boost::chrono::microseconds us) {
 
     this->_process_mavlink_messages();
@@ -50,10 +52,11 @@ void Drone::update(boost::chrono::microseconds us) {
 
     MAVLinkSystem::update(us);
     DynamicObject::update(us);
-    this->fake_ground_transform(us);
+    this->imu_sample_ready = this->sensors.integrate_imu(us);
     this->_publish_state(us);
 
     if (this->drone_state_processor != NULL) {
+        ProfileScope scope(PROFILE_OBSERVERS);
         this->drone_state_processor->new_drone_state(this->state, this->dx_state);
     }
     
@@ -64,37 +67,69 @@ MAVLinkMessageRelay& Drone::get_mavlink_message_relay() {
 }
 
 void Drone::_publish_hil_gps() {
-    this->connection.enqueue_message(
-        this->hil_gps_msg(this->system_id, this->component_id)
-    );
+    {
+        ProfileScope scope(PROFILE_ENCODING);
+        this->hil_gps_msg(this->sensor_frame, this->system_id, this->component_id, this->hil_gps_slot);
+    }
+    this->connection.enqueue_message(this->hil_gps_slot);
 }
 
 void Drone::_publish_system_time() {
-    this->connection.enqueue_message(
-        this->system_time_msg(this->system_id, this->component_id)
-    );
+    {
+        ProfileScope scope(PROFILE_ENCODING);
+        this->system_time_msg(this->system_id, this->component_id, this->system_time_slot);
+    }
+    this->connection.enqueue_message(this->system_time_slot);
 }
 
 void Drone::_publish_hil_sensor() {
-    this->connection.enqueue_message(this->hil_sensor_msg(this->system_id, this->component_id));
+    {
+        ProfileScope scope(PROFILE_ENCODING);
+        this->hil_sensor_msg(this->sensor_frame, this->system_id, this->component_id, this->hil_sensor_slot);
+    }
+    this->connection.enqueue_message(this->hil_sensor_slot);
 }
 
 void Drone::_publish_hil_state_quaternion() {
-    mavlink_message_t msg = this->hil_state_quaternion_msg(this->system_id, this->component_id);
-    this->connection.enqueue_message(msg);
+    {
+        ProfileScope scope(PROFILE_ENCODING);
+        this->hil_state_quaternion_msg(this->sensor_frame, this->system_id, this->component_id, this->hil_state_quaternion_slot);
+    }
+    this->connection.enqueue_message(this->hil_state_quaternion_slot);
 }
 
 void Drone::_publish_battery_status_msg() {
-    mavlink_message_t msg = this->battery_status_msg(this->system_id, this->component_id);
-    this->connection.enqueue_message(msg);
+    // BATTERY_STATUS goes out at its own rate, not with every sensor sample
+    double rate_hz = this->config.battery.status_rate_hz;
+    if (rate_hz <= 0) return;
+    boost::chrono::microseconds now = this->clock.get_current_time_us();
+    if (this->battery_status_sent && (now - this->last_battery_status).count() < 1000000.0 / rate_hz) return;
+    this->battery_status_sent = true;
+    this->last_battery_status = now;
+
+    {
+        ProfileScope scope(PROFILE_ENCODING);
+        this->battery_status_msg(this->get_battery_state(), this->system_id, this->component_id, this->battery_status_slot);
+    }
+    this->connection.enqueue_message(this->battery_status_slot);
 }
 
 void Drone::_publish_state(boost::chrono::microseconds us)
  {
+    TraceScope trace_scope("Drone::_publish_state");
     if (!this->connection.connection_open()) return;
     if (!(this->should_reply_lockstep || this->hil_actuator_controls_msg_n < 300)) return;
 
     this->clock.unlock_time();
+
+    // Between IMU samples the physics keeps stepping without waiting for the autopilot
+    if (!this->imu_sample_ready) return;
+
+    // Geodesy and rotations are computed once here, not once per message
+    {
+        ProfileScope scope(PROFILE_SENSOR_SAMPLING);
+        this->sensors.sample_frame(this->sensor_frame);
+    }
     
     if (this->sys_time_throttle_counter++ % 1000) {
         this->_publish_system_time();
@@ -123,7 +158,7 @@ void Drone::_publish_state(boost::chrono::microseconds us)
  * Correct command receival must be ACK'ed.
  * 
  */
-void Drone::_process_command_long_message(mavlink_message_t m) {
+void Drone::_process_command_long_message(const mavlink_message_t& m) {
     mavlink_command_long_t command;
     mavlink_message_t command_ack_msg;
     mavlink_msg_command_long_decode(&m, &command);
@@ -142,7 +177,7 @@ void Drone::_process_command_long_message(mavlink_message_t m) {
     this->connection.enqueue_message(command_ack_msg);
 }
 
-void Drone::_process_hil_actuator_controls(mavlink_message_t m) {
+void Drone::_process_hil_actuator_controls(const mavlink_message_t& m) {
     
     this->should_reply_lockstep = true;
     this->hil_actuator_controls_msg_n++;
@@ -157,38 +192,49 @@ void Drone::_process_hil_actuator_controls(mavlink_message_t m) {
         printf("\tControl #%d: %f\n", i, controls.controls[i]);
     } printf("\n");
 #endif
-    Eigen::VectorXd vec_controls{8};
-    for (int i = 0; i < 8; i++) vec_controls[i] = controls.controls[i];
+    Eigen::VectorXd vec_controls{DRONE_CONFIG_ACTUATOR_OUTPUTS};
+    for (int i = 0; i < DRONE_CONFIG_ACTUATOR_OUTPUTS; i++) vec_controls[i] = controls.controls[i];
     this->virtual_esc.set_pwm(vec_controls);
 }
 
-void Drone::_process_mavlink_message(mavlink_message_t m) {
-    ConsoleLogger* logger = ConsoleLogger::shared_instance();
+void Drone::_process_mavlink_message(const mavlink_message_t& m) {
     switch(m.msgid) {
         case MAVLINK_MSG_ID_HEARTBEAT:
-            logger->debug_log("MSG: HEARTBEAT");
+            ROUTING_LOG("MSG: HEARTBEAT");
             break;
         case MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS:
-            logger->debug_log("MSG: HIL_ACTUATOR_CONTROLS");
+            ROUTING_LOG("MSG: HIL_ACTUATOR_CONTROLS");
             this->_process_hil_actuator_controls(m);
             break;
         case MAVLINK_MSG_ID_COMMAND_LONG:
-            logger->debug_log("MSG: COMMAND_LONG");
+            ROUTING_LOG("MSG: COMMAND_LONG");
             this->_process_command_long_message(m);
             break;
         default:
-            logger->debug_log("Unknown message!");
+            ROUTING_LOG("Unknown message!");
     }
 }
 
 void Drone::_process_mavlink_messages() {
-    this->message_queue.consume_all([this](mavlink_message_t m){
+    ProfileScope scope(PROFILE_MESSAGE_DRAIN);
+    size_t drained = this->message_queue.consume_all([this](const mavlink_message_t& m){
         this->_process_mavlink_message(m);
     });
-}
-
-void Drone::handle_mavlink_message(mavlink_message_t m) {
-    this->message_queue.push(m);
+    this->queue_depth_metric.set(drained);
+}
+
+void Drone::handle_mavlink_message(const mavlink_message_t& m) {
+    if (this->message_queue.push(m)) return;
+    this->queue_dropped_metric.increment();
+    uint64_t overflows = this->message_queue.get_overflows();
+    // Report 1st, 2nd, 4th, 8th... overflow only
+    if ((overflows & (overflows - 1)) == 0) {
+        ConsoleLogger::shared_instance()->err_log(
+            "Drone inbound MAVLink queue full (capacity " +
+            std::to_string(this->message_queue.get_capacity()) +
+            ") -- " + std::to_string(overflows) + " frames dropped so far"
+        );
+    }
 }
 
 Sensors& Drone::get_sensors() {
@@ -8,8 +8,8 @@
 #include <fstream>
 #include <chrono>
 #include <boost/numeric/odeint.hpp>
-#include <boost/lockfree/queue.hpp>
-#include "Containers/DroneConfig.h"
+#include "Containers/ConfigRegistry.h"
+#include "DataStructures/SPSCQueue.h"
 #include "Interfaces/DynamicObject.h"
 #include "Interfaces/MAVLinkSystem.h"
 #include "Interfaces/Alive.h"
@@ -20,6 +20,7 @@
 #include "DroneSensors.h"
 #include "Interfaces/Clock.h"
 #include "Interfaces/DroneStateProcessor.h"
+#include "Metrics/MetricsRegistry.h"
 
 class Drone : public DynamicObject,
               public MAVLinkSystem,
@@ -30,16 +31,19 @@ protected:
     bool should_reply_lockstep = false;
     uint32_t hil_actuator_controls_msg_n = 0;
     uint32_t sys_time_throttle_counter = 0;
+    // HIL_SENSOR goes out at the IMU rate, the physics may step faster
+    bool imu_sample_ready = false;
 
     DroneStateProcessor* drone_state_processor = NULL;
     void _publish_state(boost::chrono::microseconds dt);
     void _process_mavlink_messages();
-    void fake_ground_transform(boost::chrono::microseconds us);
 private:
 
     uint8_t mav_mode = 0;
     boost::chrono::microseconds time{0};
     boost::chrono::microseconds last_autopilot_telemetry{0};
+    boost::chrono::microseconds last_battery_status{0};
+    bool battery_status_sent = false;
     uint16_t hil_state_quaternion_message_frequency = 10000; // Default frequency of 10ms
 
     bool armed = false;
@@ -48,6 +52,8 @@ private:
 // #define INITIAL_LAT 55.8609825
 // #define INITIAL_LON -4.2488787
 // #define INITIAL_ALT 2600 // mm
+// Enough to absorb the actuator frames PX4 bursts out after a hiccup
+#define DRONE_INBOUND_QUEUE_CAPACITY 1024
 #define INITIAL_LAT 55.573712
 #define INITIAL_LON -5.1303470010000005
 #define INITIAL_ALT 2600 // mm
@@ -57,17 +63,28 @@ private:
         };
 
 
-    DroneConfig config;
-    QuadrotorESC virtual_esc{config};
+    QuadrotorESC virtual_esc{this->shared_config};
 
     MAVLinkMessageRelay& connection;
-    boost::lockfree::queue<mavlink_message_t, boost::lockfree::capacity<50>> message_queue;
+    // Sampled once per published tick and shared by every HIL encoder
+    SensorFrame sensor_frame;
+    // Outbound messages are packed in place, one slot per message type
+    mavlink_message_t hil_gps_slot;
+    mavlink_message_t hil_sensor_slot;
+    mavlink_message_t hil_state_quaternion_slot;
+    mavlink_message_t system_time_slot;
+    mavlink_message_t battery_status_slot;
+    // Filled by the network thread, drained by the simulation thread
+    SPSCQueue<mavlink_message_t> message_queue;
+    // Shared by every drone of the process
+    Gauge& queue_depth_metric;
+    Counter& queue_dropped_metric;
 
     void _setup_drone();
 
-    void _process_mavlink_message(mavlink_message_t m);
-    void _process_command_long_message(mavlink_message_t m);
-    void _process_hil_actuator_controls(mavlink_message_t m);
+    void _process_mavlink_message(const mavlink_message_t& m);
+    void _process_command_long_message(const mavlink_message_t& m);
+    void _process_hil_actuator_controls(const mavlink_message_t& m);
 
     void _publish_hil_gps();
     void _publish_hil_state_quaternion();
@@ -77,17 +94,20 @@ private:
 
 public:
 
-    Drone(const char* config_file, MAVLinkMessageRelay& connection, Clock& clock);
+    // `config_file` is parsed once per process (see ConfigRegistry)
+    Drone(const char* config_file, MAVLinkMessageRelay& connection, Clock& clock, size_t inbound_queue_capacity = DRONE_INBOUND_QUEUE_CAPACITY);
+    Drone(std::shared_ptr<const DroneConfig> config, MAVLinkMessageRelay& connection, Clock& clock, size_t inbound_queue_capacity = DRONE_INBOUND_QUEUE_CAPACITY);
     ~Drone() {};
 
-    DroneConfig get_config() { return this->config; }
     bool is_armed() { return this->armed; }
+    uint64_t get_inbound_queue_overflows() { return this->message_queue.get_overflows(); }
+    size_t get_inbound_queue_high_water_mark() { return this->message_queue.get_high_water_mark(); }
 
     void update(boost::chrono::microseconds us) override;
     MAVLinkMessageRelay& get_mavlink_message_relay() override;
     // Receives mavlink message from non-main thread
     // Should store messages in queue and process them within the update loop.
-    void handle_mavlink_message(mavlink_message_t m) override;
+    void handle_mavlink_message(const mavlink_message_t& m) override;
 
     void set_drone_state_processor(DroneStateProcessor& processor) {
         this->drone_state_processor = &processor;
@@ -97,10 +117,10 @@ public:
     uint8_t get_mav_mode() override;
     Sensors& get_sensors() override;
     
-    Eigen::VectorXd get_state() override {
+    const Eigen::VectorXd& get_state() override {
         return this->state;
     }
-    Eigen::VectorXd get_dx_state() override {
+    const Eigen::VectorXd& get_dx_state() override {
         return this->dx_state;
     };
 };
@@ -1,17 +1,36 @@
 #include "DroneSensors.h"
 #include "Interfaces/DynamicObject.h"
 #include "DataStructures/LatLonAlt.h"
-#include "Helpers/baro_utils.h"
-#include "Helpers/gps_utils.h"
+#include "AtmosphereModel/ISAAtmosphere.h"
 #include "Helpers/magnetic_field_lookup.h"
 #include "Helpers/rotationMatrix.h"
 
 #define DEG_TO_RAD (M_PI / 180.0)
 #define RAD_TO_DEG (180.0 / M_PI)
+#define NT_TO_GAUSS 1e-5
+#define KELVIN_TO_CELSIUS(t) ((t) - 273.15)
+
+static MagneticGridSpec magnetic_grid_spec_for(const LatLonAlt& gps_origin) {
+    MagneticGridSpec spec;
+    spec.center = gps_origin;
+    spec.decimal_year = current_decimal_year();
+    return spec;
+}
 
 DroneSensors::DroneSensors(DynamicObject& drone, LatLonAlt gps_origin) : 
     drone(drone),
-    gps_origin(gps_origin)
+    gps_origin(gps_origin),
+    geodetic_frame(gps_origin),
+    magnetic_grid(MagneticFieldGrid::shared_grid(magnetic_grid_spec_for(gps_origin), MAGNETIC_GRID_CACHE_FILE)),
+    imu(drone.get_config().sensors.imu_rate_hz),
+    accelerometer(drone.get_config().sensors.accelerometer),
+    gyroscope(drone.get_config().sensors.gyroscope),
+    magnetometer(drone.get_config().sensors.magnetometer),
+    barometer(drone.get_config().sensors.barometer),
+    thermometer(drone.get_config().sensors.thermometer),
+    gps_position(drone.get_config().sensors.gps_position),
+    gps_velocity(drone.get_config().sensors.gps_velocity),
+    sensor_noise(5 * Sensor3d::NOISE_SIZE + 2 * Sensor1d::NOISE_SIZE)
     {}
 
 #pragma mark DRONE_STATE_GETTERS
@@ -55,25 +74,36 @@ Eigen::Vector3d DroneSensors::get_body_frame_angular_acceleration() {
 
 #pragma mark OTHER_SENSOR_DATA
 
+/**
+ * Earth frame (NED) field in gauss, interpolated from the grid around the GPS origin
+ */
+Eigen::Vector3d DroneSensors::earth_magnetic_field_for(const LatLonAlt& lat_lon_alt) {
+    return this->magnetic_grid->field(lat_lon_alt) * NT_TO_GAUSS;
+}
+
 Eigen::Vector3d DroneSensors::get_magnetic_field() {
     LatLonAlt lLa = this->get_lat_lon_alt();
-    Eigen::Vector3d magfield = magnetic_field_for_latlonalt(lLa);
+    Eigen::Vector3d magfield = this->earth_magnetic_field_for(lLa);
     return caelus_fdm::earth2body(this->drone.get_vector_state()) * magfield;
 }
 
 double DroneSensors::get_pressure() {
     LatLonAlt lLa = this->get_lat_lon_alt();
-    return alt_to_baro((double)lLa.altitude_mm / 1000.0); // mm to m
+    return ISAAtmosphere::shared_instance().at(lLa.altitude_mm / 1000.0).pressure; // mm to m
 }
 
 GPSData DroneSensors::get_gps_data() {
-    Eigen::Vector3d ground_speed = this->get_absolute_ground_speed() * 100;
+    return this->gps_data_for(this->get_lat_lon_alt(), this->get_absolute_ground_speed());
+}
+
+GPSData DroneSensors::gps_data_for(const LatLonAlt& lat_lon_alt, const Eigen::Vector3d& ground_speed_ms) {
+    Eigen::Vector3d ground_speed = ground_speed_ms * 100;
     GroundSpeed gs{static_cast<int16_t>(ground_speed[0]), static_cast<int16_t>(ground_speed[1]), static_cast<int16_t>(ground_speed[2])};
 
     GPSData data{
         // GPS fix type
         3,
-        this->get_lat_lon_alt(),
+        lat_lon_alt,
         // Diluition of position measurements
         // Should smooth overtime from high value to low value
         // to simulate improved measurement accuracy over time.
@@ -106,12 +136,19 @@ uint16_t DroneSensors::get_course_over_ground() {
     return fmod(RAD_TO_DEG * (angle), 360) * 100; // Deg => cDeg
 }
 
+/**
+ * Wind (NED) at the vehicle in m/s, mean field plus turbulence
+ */
 Eigen::Vector3d DroneSensors::get_environment_wind() {
-    return Eigen::VectorXd::Zero(3);
+    return this->drone.get_wind();
 }
 
+/**
+ * ISA air temperature at the vehicle altitude
+ */
 double DroneSensors::get_environment_temperature() {
-    return 25;
+    LatLonAlt lLa = this->get_lat_lon_alt();
+    return KELVIN_TO_CELSIUS(ISAAtmosphere::shared_instance().at(lLa.altitude_mm / 1000.0).temperature); // mm to m
 }
 
 /**
@@ -123,9 +160,12 @@ Eigen::Vector3d DroneSensors::get_absolute_ground_speed() {
     return earth_frame_velocity;
 }
 
+/**
+ * Airspeed in m/s: ground speed relative to the air mass
+ */
 uint16_t DroneSensors::get_true_wind_speed() {
     Eigen::Vector3d ground_speed_vec = this->get_absolute_ground_speed();
-    return (ground_speed_vec * -1).norm();
+    return (ground_speed_vec - this->drone.get_wind()).norm();
 }
 
 /**
@@ -134,37 +174,79 @@ uint16_t DroneSensors::get_true_wind_speed() {
  * alt: [mm]
  */
 LatLonAlt DroneSensors::get_lat_lon_alt() {
-    LatLonAlt lLa;
-
-    Eigen::VectorXd state = this->drone.get_vector_state();
-    double lat_lon_alt[3] = {0};
-
-    ned_to_ecef(
-        this->gps_origin.latitude_deg,
-        this->gps_origin.longitude_deg,
-        this->gps_origin.altitude_mm / 1000,
-        state,
-        lat_lon_alt[0],
-        lat_lon_alt[1],
-        lat_lon_alt[2]
-    );
+    Eigen::Vector3d ned = this->drone.get_vector_state().segment<3>(0);
+    return this->geodetic_frame.ned_to_lla(ned, this->geodetic_accuracy);
+}
 
-    ecef_to_geodetic(
-        lat_lon_alt[0],
-        lat_lon_alt[1],
-        lat_lon_alt[2],
-        lat_lon_alt[0],
-        lat_lon_alt[1],
-        lat_lon_alt[2]
-    );        
+bool DroneSensors::new_gps_data() {
+    return true;
+}
 
-    lLa.latitude_deg = lat_lon_alt[0];
-    lLa.longitude_deg = lat_lon_alt[1];
-    lLa.altitude_mm = lat_lon_alt[2] * 1000; // m to mm
+/**
+ * Rotations and geodetic position are computed once here
+ * and reused for every field derived from them.
+ */
+void DroneSensors::sample_frame(SensorFrame& frame) {
+    const Eigen::VectorXd& state = this->drone.get_vector_state();
+    const Eigen::VectorXd& dx_state = this->drone.get_vector_dx_state();
+
+    frame.earth_position = state.segment<3>(0);
+    frame.body_velocity = state.segment<3>(3);
+    frame.earth_attitude = state.segment<3>(6);
+    frame.body_gyro = state.segment<3>(9);
+    frame.earth_velocity = dx_state.segment<3>(0);
+    frame.body_acceleration = dx_state.segment<3>(3);
+    frame.earth_angle_rates = dx_state.segment<3>(6);
+
+    frame.body2earth = caelus_fdm::body2earth(state);
+    frame.earth2body = frame.body2earth.transpose();
+
+    frame.lat_lon_alt = this->get_lat_lon_alt();
+    frame.magnetic_field = frame.earth2body * this->earth_magnetic_field_for(frame.lat_lon_alt);
+    AtmosphereState atmosphere = ISAAtmosphere::shared_instance().at(frame.lat_lon_alt.altitude_mm / 1000.0); // mm to m
+    frame.pressure = atmosphere.pressure;
+    frame.temperature = KELVIN_TO_CELSIUS(atmosphere.temperature);
+    frame.ground_speed = this->get_absolute_ground_speed();
+    frame.true_wind_speed = this->get_true_wind_speed();
+
+    // Every error model is fed from the same batch of normal draws,
+    // inertial ones from the averages of the last IMU interval
+    double t = this->drone.get_current_time_us().count() / 1000000.0;
+    const double* noise = this->sensor_noise.draw();
+    this->accelerometer.update(t, this->imu.get_specific_force(), noise);
+    noise += Sensor3d::NOISE_SIZE;
+    this->gyroscope.update(t, this->imu.get_angular_rate(), noise);
+    noise += Sensor3d::NOISE_SIZE;
+    this->magnetometer.update(t, frame.magnetic_field, noise);
+    noise += Sensor3d::NOISE_SIZE;
+    this->barometer.update(t, Eigen::Matrix<double, 1, 1>{frame.pressure}, noise);
+    noise += Sensor1d::NOISE_SIZE;
+    this->thermometer.update(t, Eigen::Matrix<double, 1, 1>{frame.temperature}, noise);
+    noise += Sensor1d::NOISE_SIZE;
+    this->gps_position.update(t, frame.earth_position, noise);
+    noise += Sensor3d::NOISE_SIZE;
+    this->gps_velocity.update(t, frame.ground_speed, noise);
+
+    frame.accelerometer = this->accelerometer.get();
+    frame.gyroscope = this->gyroscope.get();
+    frame.magnetometer = this->magnetometer.get();
+    frame.barometer_pressure = this->barometer.get()[0];
+    frame.thermometer_temperature = this->thermometer.get()[0];
+    LatLonAlt gps_lat_lon_alt = this->geodetic_frame.ned_to_lla(this->gps_position.get(), this->geodetic_accuracy);
+    frame.gps_data = this->gps_data_for(gps_lat_lon_alt, this->gps_velocity.get());
+}
 
-    return lLa;
+/**
+ * Accelerometers measure the specific force
+ */
+Eigen::Vector3d DroneSensors::specific_force_for(const Eigen::Matrix3d& body2earth) {
+    Eigen::Vector3d specific_force = body2earth * this->get_body_frame_acceleration();
+    specific_force[2] -= G_FORCE;
+    return body2earth.transpose() * specific_force;
 }
 
-bool DroneSensors::new_gps_data() {
-    return true;
+bool DroneSensors::integrate_imu(boost::chrono::microseconds us) {
+    const Eigen::VectorXd& state = this->drone.get_vector_state();
+    Eigen::Matrix3d body2earth = caelus_fdm::body2earth(state);
+    return this->imu.integrate(us.count() / 1000000.0, state.segment<3>(9), this->specific_force_for(body2earth));
 }
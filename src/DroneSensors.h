@@ -4,15 +4,43 @@
 #include "Interfaces/Sensors.h"
 #include "Interfaces/DynamicObject.h"
 #include "Interfaces/TimeHandler.h"
+#include "Interfaces/Sensor.h"
+#include "IMUModel/IMUIntegrator.h"
+#include "MagneticModel/MagneticFieldGrid.h"
+#include "Helpers/LocalGeodeticFrame.h"
+
+// Cache of the magnetic grid around the GPS origin (reused across runs)
+#define MAGNETIC_GRID_CACHE_FILE "WMM_GRID.bin"
 
 class DroneSensors : public Sensors {
     
 protected:
     DynamicObject& drone;
     LatLonAlt gps_origin;
+    LocalGeodeticFrame geodetic_frame;
+    GeodeticAccuracy geodetic_accuracy = EXACT;
+    std::shared_ptr<const MagneticFieldGrid> magnetic_grid;
+
+    // Integrated every physics step, feeds the accelerometer and gyroscope
+    IMUIntegrator imu;
+
+    // Sensor error models, updated once per sampled frame
+    Sensor3d accelerometer;
+    Sensor3d gyroscope;
+    Sensor3d magnetometer;
+    Sensor1d barometer;
+    Sensor1d thermometer;
+    Sensor3d gps_position;
+    Sensor3d gps_velocity;
+    SensorNoise sensor_noise;
+
+    GPSData gps_data_for(const LatLonAlt& lat_lon_alt, const Eigen::Vector3d& ground_speed);
+    Eigen::Vector3d specific_force_for(const Eigen::Matrix3d& body2earth);
+    Eigen::Vector3d earth_magnetic_field_for(const LatLonAlt& lat_lon_alt);
 public:
     DroneSensors(DynamicObject& drone, LatLonAlt gps_origin);
     ~DroneSensors() {};
+    void set_geodetic_accuracy(GeodeticAccuracy accuracy) { this->geodetic_accuracy = accuracy; }
     Eigen::Vector3d get_earth_frame_position() override;
     Eigen::Vector3d get_body_frame_velocity() override;
     Eigen::Vector3d get_earth_frame_attitude() override;
@@ -32,6 +60,9 @@ public:
     uint16_t get_true_wind_speed() override;
     Eigen::Vector3d get_absolute_ground_speed() override;
     double get_environment_temperature() override;
+    void sample_frame(SensorFrame& frame) override;
+    // Called after every physics step, true when a new IMU sample is available
+    bool integrate_imu(boost::chrono::microseconds us);
 };
 
 #endif // __DRONESENSORS_H__
\ No newline at end of file
@@ -1,25 +1,23 @@
 #ifndef __QUADROTOR_ESC_H__
 #define __QUADROTOR_ESC_H__
 #include <tgmath.h> 
+#include <memory>
 #include "../Interfaces/AsyncDroneControl.h"
 #include "../Containers/DroneConfig.h"
 
 class QuadrotorESC : public AsyncDroneControl {
 private:
-    DroneConfig config;
-    uint8_t pwm_control_size = 8;
+    std::shared_ptr<const DroneConfig> config;
+    uint8_t pwm_control_size = DRONE_CONFIG_ACTUATOR_OUTPUTS;
     Eigen::VectorXd last_pwm = Eigen::VectorXd::Zero(pwm_control_size);
-    Eigen::VectorXd last_control = Eigen::VectorXd::Zero(4);
 protected:
+    // Commanded rotor speeds, the motor lag is integrated with the vehicle state (see RotorDynamics)
     Eigen::VectorXd control_for_vtol_propellers(Eigen::VectorXd vtol_pwm) {
-        Eigen::VectorXd ret{4};
-        double dt = 0.004;
-        std::vector<int> control_remap = {0, 3, 1, 2};
-
-        for (auto i = 0; i < 4; i++) {
-            auto new_pwm = (this->last_control[i] + (vtol_pwm[control_remap[i]] - this->last_control[i]) * (1.0 - exp(-dt / this->config.vtol_tau)));
-            this->last_control[i] = new_pwm;
-            ret[i] = new_pwm * this->config.vtol_kv;
+        const auto& rotors = this->config->rotors;
+        Eigen::VectorXd ret{rotors.size()};
+
+        for (size_t i = 0; i < rotors.size(); i++) {
+            ret[i] = vtol_pwm[rotors[i].output] * this->config->vtol_kv;
         }
 
         return ret;
@@ -34,21 +32,26 @@ protected:
     }
 
 public:
-    QuadrotorESC(DroneConfig config) : config(config) {};
+    QuadrotorESC(std::shared_ptr<const DroneConfig> config) : config(config) {};
 
+    // [rotor speeds (DroneConfig::rotors order), thrust propeller (2), elevons (2)]
     Eigen::VectorXd control(double dt) override {
-        Eigen::VectorXd controls{this->pwm_control_size};
-        Eigen::VectorXd vtol_control = this->control_for_vtol_propellers(this->last_pwm.segment(0, 4));
+        const int rotors = this->config->rotors.size();
+        Eigen::VectorXd controls{rotors + 4};
+        Eigen::VectorXd vtol_control = this->control_for_vtol_propellers(this->last_pwm);
         Eigen::VectorXd thrust_control = this->control_for_thrust_propeller(this->last_pwm.segment(4, 2));
         Eigen::VectorXd elevons_control = this->control_for_elevons(this->last_pwm.segment(6, 2));
-        controls.segment(0, 4) = vtol_control;
-        controls.segment(4, 2) = thrust_control;
-        controls.segment(6, 2) = elevons_control;
+        controls.segment(0, rotors) = vtol_control;
+        controls.segment(rotors, 2) = thrust_control;
+        controls.segment(rotors + 2, 2) = elevons_control;
         return controls;
     }
 
+    // Actuator outputs, missing trailing ones are off
     void set_pwm(Eigen::VectorXd c) override {
-        this->last_pwm = c;
+        Eigen::Index n = std::min<Eigen::Index>(c.size(), this->pwm_control_size);
+        this->last_pwm.setZero();
+        this->last_pwm.head(n) = c.head(n);
     }
 };
 
@@ -1,26 +1,27 @@
 #ifndef __SIMPLE_FIXEDWINGESC_H__
 #define __SIMPLE_FIXEDWINGESC_H__
 
+#include <memory>
 #include "../Interfaces/AsyncDroneControl.h"
 #include "../Containers/DroneConfig.h"
 
 class SimpleFixedWingESC : public AsyncDroneControl {
 private:
-    DroneConfig config;
-    uint8_t pwm_control_size = 8;
-    Eigen::VectorXd last_control{pwm_control_size};
+    std::shared_ptr<const DroneConfig> config;
+    uint8_t pwm_control_size = DRONE_CONFIG_ACTUATOR_OUTPUTS;
+    Eigen::VectorXd last_control = Eigen::VectorXd::Zero(pwm_control_size);
 protected:
     Eigen::VectorXd control_for_vtol_propellers(Eigen::VectorXd vtol_pwm) {
-        Eigen::VectorXd ret{4};
+        const auto& rotors = this->config->rotors;
+        Eigen::VectorXd ret{rotors.size()};
         // (2.0*...) => With 0.5 pwm control we must get a hover
         // This is to make sure that the SimpleFixedWingController is able to manoeuver without being a
         // full blown PID controller (it has no feedback)
-        double omega = 2.0*sqrt(this->config.mass*9.81/this->config.vtol_komega/4.);
+        double omega = 2.0*sqrt(this->config->mass*9.81/this->config->vtol_komega/rotors.size());
 
-        ret[0] = omega * vtol_pwm[0];
-        ret[1] = omega * vtol_pwm[3];
-        ret[2] = omega * vtol_pwm[1];
-        ret[3] = omega * vtol_pwm[2];
+        for (size_t i = 0; i < rotors.size(); i++) {
+            ret[i] = omega * vtol_pwm[rotors[i].output];
+        }
 
         return ret;
     }
@@ -34,21 +35,26 @@ protected:
     }
 
 public:
-    SimpleFixedWingESC(DroneConfig config) : config(config) {};
+    SimpleFixedWingESC(std::shared_ptr<const DroneConfig> config) : config(config) {};
 
+    // [rotor speeds (DroneConfig::rotors order), thrust propeller (2), elevons (2)]
     Eigen::VectorXd control(double dt) override {
-        Eigen::VectorXd controls{this->pwm_control_size};
-        Eigen::VectorXd vtol_control = this->control_for_vtol_propellers(this->last_control.segment(0, 4));
+        const int rotors = this->config->rotors.size();
+        Eigen::VectorXd controls{rotors + 4};
+        Eigen::VectorXd vtol_control = this->control_for_vtol_propellers(this->last_control);
         Eigen::VectorXd thrust_control = this->control_for_thrust_propeller(this->last_control.segment(4, 2));
         Eigen::VectorXd elevons_control = this->control_for_elevons(this->last_control.segment(6, 2));
-        controls.segment(0, 4) = vtol_control;
-        controls.segment(4, 2) = thrust_control;
-        controls.segment(6, 2) = elevons_control;
+        controls.segment(0, rotors) = vtol_control;
+        controls.segment(rotors, 2) = thrust_control;
+        controls.segment(rotors + 2, 2) = elevons_control;
         return controls;
     }
 
+    // Actuator outputs, missing trailing ones are off
     void set_pwm(Eigen::VectorXd c) override {
-        this->last_control = c;
+        Eigen::Index n = std::min<Eigen::Index>(c.size(), this->pwm_control_size);
+        this->last_control.setZero();
+        this->last_control.head(n) = c.head(n);
     }
 };
 
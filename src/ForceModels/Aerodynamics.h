@@ -10,8 +10,15 @@
 #ifndef CAELUS_FDM_AERODYNAMICS_H
 #define CAELUS_FDM_AERODYNAMICS_H
 
+#include <memory>
 #include "BaseFM.h"
 #include "../Helpers/constants.h"
+#include "../Helpers/rotationMatrix.h"
+#include "../AtmosphereModel/ISAAtmosphere.h"
+#include "../AeroModel/AeroCoefficientTable.h"
+
+// Minimum simulation time (s) between two stall warnings
+#define AERO_STALL_WARNING_INTERVAL 1.0
 
 namespace caelus_fdm {
 
@@ -44,13 +51,21 @@ namespace caelus_fdm {
         double m_alpha; //!< \brief angle of attack
         double m_beta; //!< \brief angle of sideslip
         double m_Va; //!< \brief Velocity Amplitude
+        Eigen::Vector3d m_wind{0, 0, 0}; //!< \brief Wind velocity (NED)
+        Eigen::Vector3d m_Vr{0, 0, 0}; //!< \brief Airspeed (Body Fixed)
         Eigen::VectorXd m_Delta; //!< \brief Aerodynamic surfaces deflection (m_Delta[0] = d_e, m_Delta[1] = d_a)
 
-        double m_rho, m_T; //!< \brief density and temperature
+        double m_rho, m_T, m_a; //!< \brief density, temperature and speed of sound
         double m_c, m_b; //!< \brief Characteristic lenghts for forces and moments
         double m_S; //!< \brief Characteristic area for forces and moments
 
         APM m_data; //!< \brief Infos on aerodynamic performance
+        shared_ptr<const AeroCoefficientTable> m_table; //!< \brief Static coefficients over the whole envelope, optional
+        double m_table_C[AERO_TABLE_COEFFICIENTS]; //!< \brief CD, CS, CL, Cl, Cm, Cn read from m_table
+        bool m_table_beta = false, m_table_delta_e = false, m_table_delta_a = false; //!< \brief Variables tabulated (linear terms dropped)
+
+        uint64_t m_stall_count = 0; //!< \brief Evaluations with the angle of attack clamped
+        double m_stall_warning_t = 0; //!< \brief Time of the last stall warning
 
         // For small angles of attack CL = CL(alpha, Delta_e, q)
         double m_CD, m_CS, m_CL; //!< \brief Resultant Aerodynamic Forces Coefficients
@@ -58,24 +73,51 @@ namespace caelus_fdm {
 
         function<Eigen::VectorXd(double)> m_controller;
 
+        // ISA density and temperature at the height above the NED origin
         int computeTrho(const State &x){
-            m_rho = 1.225;
-            m_T = 288.15;
+            AtmosphereState atmosphere = ISAAtmosphere::shared_instance().at(-x[2]);
+            m_rho = atmosphere.density;
+            m_T = atmosphere.temperature;
+            m_a = atmosphere.speed_of_sound;
+            return 0;
+        }
+
+        // Velocity relative to the air mass, in body frame
+        int computeAirspeed(const State &x){
+            m_Vr = x.segment<3>(3) - earth2body(x) * m_wind;
             return 0;
         }
 
-        int computeAngles(const State &x){
-            m_alpha = atan2(x[5],x[3]); 
-            if (m_alpha < DEG_TO_RAD * -5 || m_alpha > DEG_TO_RAD * 15) { // STALLING
-                fprintf(stderr, "[WARNING] The aricraft is stalling (a.o.a: %f deg)-- maintain attitude between (-5 - +15)deg angle of attack!\n", m_alpha * RAD_TO_DEG);
+        int computeAngles(const double &t, const State &x){
+            m_alpha = atan2(m_Vr[2],m_Vr[0]); 
+            // The linear derivatives only hold between -5 and 15 deg, a table covers the whole envelope
+            if (!m_table && (m_alpha < DEG_TO_RAD * -5 || m_alpha > DEG_TO_RAD * 15)) { // STALLING
+                if (m_stall_count == 0 || t - m_stall_warning_t >= AERO_STALL_WARNING_INTERVAL) {
+                    fprintf(stderr, "[WARNING] The aricraft is stalling (a.o.a: %f deg, %llu stalled evaluations)-- maintain attitude between (-5 - +15)deg angle of attack!\n",
+                        m_alpha * RAD_TO_DEG, (unsigned long long)m_stall_count + 1);
+                    m_stall_warning_t = t;
+                }
+                m_stall_count++;
                 m_alpha = m_alpha < 0 ? DEG_TO_RAD * -5 : DEG_TO_RAD * 15;
             }
-            m_beta = asin(x[4]/sqrt(x[3]*x[3]+x[4]*x[4]+x[5]*x[5]));
+            m_beta = asin(m_Vr[1]/m_Vr.norm());
             return 0;
         }
 
         int computeVmod(const State &x){
-            m_Va = sqrt(x[3]*x[3]+x[4]*x[4]+x[5]*x[5]);
+            m_Va = m_Vr.norm();
+            return 0;
+        }
+
+        int computeTableCoefficients(){
+            double variables[AERO_TABLE_VARIABLES];
+            variables[AERO_TABLE_ALPHA] = m_alpha;
+            variables[AERO_TABLE_BETA] = m_beta;
+            variables[AERO_TABLE_AIRSPEED] = m_Va;
+            variables[AERO_TABLE_MACH] = m_Va / m_a;
+            variables[AERO_TABLE_DELTA_E] = m_Delta[0];
+            variables[AERO_TABLE_DELTA_A] = m_Delta[1];
+            m_table->coefficients_at(variables, m_table_C);
             return 0;
         }
 
@@ -93,6 +135,24 @@ namespace caelus_fdm {
         double getrho(){
             return m_rho;
         }
+
+        // Evaluations that clamped the angle of attack to the linear range
+        uint64_t getStallCount(){
+            return m_stall_count;
+        }
+
+        /**
+         * Takes the static coefficients from a table instead of the linear derivatives,
+         * the rate (p, q, r) derivatives and those of untabulated beta and deflections still apply.
+         * @param table : loaded table, NULL to go back to the linear model
+         */
+        int setCoefficientTable(shared_ptr<const AeroCoefficientTable> table){
+            m_table = move(table);
+            m_table_beta = m_table && m_table->has_variable(AERO_TABLE_BETA);
+            m_table_delta_e = m_table && m_table->has_variable(AERO_TABLE_DELTA_E);
+            m_table_delta_a = m_table && m_table->has_variable(AERO_TABLE_DELTA_A);
+            return 0;
+        }
         /**
          * Evaluate  Aerodynamic force/moment [Gryte, “Aerodynamic  modeling  of  the  Skywalker  X8  Fixed-Wing  UnmannedAerial  Vehicle”]
          * @param t : time
@@ -106,6 +166,8 @@ namespace caelus_fdm {
          */
         int computeF(const double &t, const State &x) override {
 
+            if (m_table) return computeTableF(t, x);
+
             m_CD = m_data.m_CD_0 + m_data.m_CD_alpha*m_alpha + m_data.m_CD_alpha2*m_alpha*m_alpha +
                     m_data.m_CD_delta_e2*m_Delta[0]*m_Delta[0] + m_data.m_CD_beta*m_beta +
                     m_data.m_CD_beta2*m_beta*m_beta + m_data.m_CD_q*m_c/(2.*m_Va)*x[10];
@@ -124,6 +186,8 @@ namespace caelus_fdm {
 
         int computeM(const double &t, const State &x) override {
 
+            if (m_table) return computeTableM(t, x);
+
             m_Cl = m_data.m_Cl_0 + m_data.m_Cl_beta*m_beta + m_data.m_Cl_delta_a*m_Delta[1] +
                     m_b/(2.*m_Va)*(m_data.m_Cl_p*x[9] + m_data.m_Cl_r*x[11]);
             m_Cm = m_data.m_Cm_0 + m_data.m_Cm_alpha*m_alpha + m_data.m_Cm_delta_e*m_Delta[0] +
@@ -138,20 +202,73 @@ namespace caelus_fdm {
             return 0;
         }
 
+        int computeTableF(const double &t, const State &x) {
+
+            m_CD = m_table_C[0] + m_data.m_CD_q*m_c/(2.*m_Va)*x[10];
+            m_CS = m_table_C[1] + m_b/(2.*m_Va)*(m_data.m_CS_p*x[9] + m_data.m_CS_r*x[11]);
+            m_CL = m_table_C[2] + m_data.m_CL_q*m_c/(2.*m_Va)*x[10];
+            if (!m_table_beta) {
+                m_CD += m_data.m_CD_beta*m_beta + m_data.m_CD_beta2*m_beta*m_beta;
+                m_CS += m_data.m_CS_beta*m_beta;
+            }
+            if (!m_table_delta_e) {
+                m_CD += m_data.m_CD_delta_e2*m_Delta[0]*m_Delta[0];
+                m_CL += m_data.m_CL_delta_e*m_Delta[0];
+            }
+            if (!m_table_delta_a) m_CS += m_data.m_CS_delta_a*m_Delta[1];
+
+            m_F.resize(3);
+            m_F[0] = -0.5*m_rho*m_Va*m_Va*m_S*m_CD;
+            m_F[1] = 0.5*m_rho*m_Va*m_Va*m_S*m_CS;
+            m_F[2] = -0.5*m_rho*m_Va*m_Va*m_S*m_CL;
+
+            return 0;
+        }
+
+        int computeTableM(const double &t, const State &x) {
+
+            m_Cl = m_table_C[3] + m_b/(2.*m_Va)*(m_data.m_Cl_p*x[9] + m_data.m_Cl_r*x[11]);
+            m_Cm = m_table_C[4] + m_data.m_Cm_q*m_c/(2.*m_Va)*x[10];
+            m_Cn = m_table_C[5] + m_b/(2.*m_Va)*(m_data.m_Cn_p*x[9] + m_data.m_Cn_r*x[11]);
+            if (!m_table_beta) {
+                m_Cl += m_data.m_Cl_beta*m_beta;
+                m_Cn += m_data.m_Cn_beta*m_beta;
+            }
+            if (!m_table_delta_e) m_Cm += m_data.m_Cm_delta_e*m_Delta[0];
+            if (!m_table_delta_a) {
+                m_Cl += m_data.m_Cl_delta_a*m_Delta[1];
+                m_Cn += m_data.m_Cn_delta_a*m_Delta[1];
+            }
+
+            m_M.resize(3);
+            m_M[0] = 0.5*m_rho*m_Va*m_Va*m_Cl*m_S*m_b;
+            m_M[1] = 0.5*m_rho*m_Va*m_Va*m_Cm*m_S*m_c;
+            m_M[2] = 0.5*m_rho*m_Va*m_Va*m_Cn*m_S*m_b;
+            return 0;
+        }
+
         using BaseFM::getF;
         using BaseFM::getM;
         using BaseFM::updateParams;
 
         int updateParamsImpl(const double &t, const State &x) override {
             this->computeTrho(x);
-            this->computeAngles(x);
+            this->computeAirspeed(x);
+            this->computeAngles(t, x);
             this->computeVmod(x);
             m_Delta = m_controller(t);
+            if (m_table) this->computeTableCoefficients();
             auto state_F = this->computeF(t,x);
             auto state_M = this->computeM(t,x);
             return 0;
         }
 
+        // Wind velocity (NED, m/s) used for the next update
+        int setWind(const Eigen::Vector3d& wind) {
+            m_wind = wind;
+            return 0;
+        }
+
         int setController(function<Eigen::VectorXd(double)> controller) {
             m_controller = controller;
             return 0;
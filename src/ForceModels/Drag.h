@@ -13,6 +13,7 @@
 #include "../Helpers/rotationMatrix.h"
 #include "BaseFM.h"
 #include "../Containers/DroneConfig.h"
+#include "../AtmosphereModel/ISAAtmosphere.h"
 
 namespace caelus_fdm {
 
@@ -21,14 +22,18 @@ namespace caelus_fdm {
     protected:
 
         // Attributes
-        double rho = 1.225;  // air density
+        double rho = 1.225;  // air density (ISA, updated with altitude)
+        double rho_sea_level = 1.225;
         double drag_coefficient = 0.157;     // drag coeff
+        Eigen::Vector3d wind{0, 0, 0};  // wind velocity (NED)
 
     public:
 
-        explicit Drag(DroneConfig config) :
-            BaseFM(), rho(1.225), drag_coefficient(0.157)
+        explicit Drag(const DroneConfig& config) :
+            BaseFM(), drag_coefficient(0.157)
         {
+            this->rho_sea_level = ISAAtmosphere::shared_instance().at(0).density;
+            this->rho = this->rho_sea_level;
             printf("Drag model initialised with params:\n");
             printf("\t rho: %f\n", rho);
             printf("\t drag_coefficient: %f\n", drag_coefficient);
@@ -49,8 +54,10 @@ namespace caelus_fdm {
          */
         int computeF(const double &t, const State &x) override {
             m_F.resize(3);
-            Eigen::Vector3d airspeed = earth2body(x) * (Eigen::Vector3d{-x[3], -x[4], -x[5]});
-            m_F = airspeed * 3.0 * 0.1;
+            // Opposes the body frame velocity relative to the air mass
+            Eigen::Vector3d airspeed = x.segment<3>(3) - earth2body(x) * this->wind;
+            // Drag scales with density: thinner air at altitude
+            m_F = -airspeed * 3.0 * 0.1 * (this->rho / this->rho_sea_level);
             return 0;
         }
         int computeM(const double &t, const State &x) override {
@@ -61,7 +68,13 @@ namespace caelus_fdm {
             return 0;
         }
 
+        // Wind velocity (NED, m/s) used for the next update
+        void setWind(const Eigen::Vector3d& wind) {
+            this->wind = wind;
+        }
+
         int updateParamsImpl(const double &t, const State &x) override {
+            this->rho = ISAAtmosphere::shared_instance().at(-x[2]).density;
             auto state_F = this->computeF(t,x);
             auto state_M = this->computeM(t,x);
             return 0;
@@ -0,0 +1,68 @@
+#ifndef __THRUSTMULTIROTOR_H__
+#define __THRUSTMULTIROTOR_H__
+
+#include <stdio.h>
+#include <Eigen/Eigen>
+#include "BaseFM.h"
+#include "../Containers/DroneConfig.h"
+
+/**
+ * Thrust and reaction torque of the VTOL rotors of any layout (see @Containers/RotorConfig).
+ *
+ * The rotor geometry is folded into a 6 x 2N mixing matrix once, the wrench
+ * [F; M] of N rotors spinning at w is then mixing * [w**2; w].
+ */
+class ThrustMultirotor : public caelus_fdm::BaseFM {
+private:
+    Eigen::Matrix<double, 6, Eigen::Dynamic> mixing;
+    // [w**2; w] of the rotors, then the wrench they produce
+    Eigen::VectorXd speed_terms;
+    Eigen::Matrix<double, 6, 1> wrench;
+
+public:
+    ThrustMultirotor(const DroneConfig& config) :
+        mixing(Eigen::Matrix<double, 6, Eigen::Dynamic>::Zero(6, 2 * config.rotors.size())),
+        speed_terms(Eigen::VectorXd::Zero(2 * config.rotors.size()))
+    {
+        const int n = config.rotors.size();
+        for (int i = 0; i < n; i++) {
+            const RotorConfig& rotor = config.rotors[i];
+            Eigen::Vector3d thrust = rotor.thrust_coefficient * rotor.axis;
+            // Reaction torque opposes the spin: about -axis when counter-clockwise
+            Eigen::Vector3d torque_axis = -rotor.direction * rotor.axis;
+            this->mixing.block<3, 1>(0, i) = thrust;
+            this->mixing.block<3, 1>(3, i) = rotor.position.cross(thrust) + rotor.torque_coefficient * torque_axis;
+            this->mixing.block<3, 1>(3, n + i) = config.vtol_tdrag * torque_axis;
+        }
+        this->wrench.setZero();
+        printf("Multirotor thrust model initialised with %d rotors\n", n);
+    }
+
+    int size() const { return this->mixing.cols() / 2; }
+
+    int computeF(const double &t, const caelus_fdm::State &x) override {
+        this->m_F = this->wrench.head<3>();
+        return 0;
+    }
+
+    int computeM(const double &t, const caelus_fdm::State &x) override {
+        this->m_M = this->wrench.tail<3>();
+        return 0;
+    }
+
+    /**
+     * Force/moment for rotor speeds integrated outside the model (e.g. as ODE states)
+     * @param Omega : rotor speeds (rad/s), in the order of DroneConfig::rotors
+     */
+    int setRotorSpeeds(const double &t, const caelus_fdm::State &x, const Eigen::VectorXd &Omega) {
+        const int n = this->size();
+        this->speed_terms.head(n) = Omega.array().square();
+        this->speed_terms.tail(n) = Omega;
+        this->wrench.noalias() = this->mixing * this->speed_terms;
+        this->computeF(t, x);
+        this->computeM(t, x);
+        return 0;
+    }
+};
+
+#endif // __THRUSTMULTIROTOR_H__
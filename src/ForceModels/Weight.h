@@ -26,7 +26,7 @@ namespace caelus_fdm {
 
     public:
 
-        explicit Weight(DroneConfig config ,double g = 9.81) :
+        explicit Weight(const DroneConfig& config, double g = 9.81) :
             BaseFM(), mass(config.mass), m_g(g)
         {
             printf("Weight model initialised with params:\n");
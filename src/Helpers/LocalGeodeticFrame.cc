@@ -0,0 +1,76 @@
+#include <cmath>
+#include "LocalGeodeticFrame.h"
+#include "gps_utils.h"
+
+LocalGeodeticFrame::LocalGeodeticFrame(const LatLonAlt& origin) : origin(origin) {
+    this->origin_lat_rad = origin.latitude_deg * DEG_TO_RAD;
+    this->origin_lon_rad = origin.longitude_deg * DEG_TO_RAD;
+    this->origin_alt_m = origin.altitude_mm / 1000; // mm to m
+
+    double sin_lat = sin(this->origin_lat_rad);
+    double cos_lat = cos(this->origin_lat_rad);
+    double sin_lon = sin(this->origin_lon_rad);
+    double cos_lon = cos(this->origin_lon_rad);
+
+    // Prime vertical and meridian radii of curvature
+    double w_sq = 1 - e_sq * sin_lat * sin_lat;
+    double prime_vertical = a / sqrt(w_sq);
+    double meridian = a * (1 - e_sq) / (w_sq * sqrt(w_sq));
+
+    this->origin_ecef <<
+        (this->origin_alt_m + prime_vertical) * cos_lat * cos_lon,
+        (this->origin_alt_m + prime_vertical) * cos_lat * sin_lon,
+        (this->origin_alt_m + (1 - e_sq) * prime_vertical) * sin_lat;
+
+    // Columns: north, east, down unit vectors in ECEF
+    this->ned2ecef <<
+        -sin_lat * cos_lon, -sin_lon, -cos_lat * cos_lon,
+        -sin_lat * sin_lon,  cos_lon, -cos_lat * sin_lon,
+         cos_lat,            0,       -sin_lat;
+
+    this->inv_meridian = 1.0 / (meridian + this->origin_alt_m);
+    this->inv_prime_vertical = 1.0 / (prime_vertical + this->origin_alt_m);
+    this->tan_lat = sin_lat / cos_lat;
+    this->sec_lat = 1.0 / cos_lat;
+}
+
+Eigen::Vector3d LocalGeodeticFrame::ned_to_ecef(const Eigen::Vector3d& ned) const {
+    return this->origin_ecef + this->ned2ecef * ned;
+}
+
+LatLonAlt LocalGeodeticFrame::ned_to_lla(const Eigen::Vector3d& ned, GeodeticAccuracy accuracy) const {
+    LatLonAlt lla;
+    this->ned_to_lla(&ned, &lla, 1, accuracy);
+    return lla;
+}
+
+void LocalGeodeticFrame::ned_to_lla(const Eigen::Vector3d* ned, LatLonAlt* lla, size_t n, GeodeticAccuracy accuracy) const {
+    if (accuracy == FLAT_EARTH) {
+        for (size_t i = 0; i < n; i++) {
+            double north = ned[i][0];
+            double east = ned[i][1];
+            double down = ned[i][2];
+            // Second order terms: the origin's down axis tilts away from the local vertical
+            // and parallels curve away from the tangent plane
+            double dlat = north * this->inv_meridian * (1 + down * this->inv_meridian)
+                - 0.5 * east * east * this->tan_lat * this->inv_meridian * this->inv_prime_vertical;
+            double dlon = this->sec_lat * this->inv_prime_vertical
+                * (east * (1 + down * this->inv_prime_vertical) + north * east * this->tan_lat * this->inv_meridian);
+            lla[i].latitude_deg = this->origin.latitude_deg + dlat * RAD_TO_DEG;
+            lla[i].longitude_deg = this->origin.longitude_deg + dlon * RAD_TO_DEG;
+            // The ellipsoid drops away from the tangent plane quadratically with distance
+            double alt_m = this->origin_alt_m - down
+                + 0.5 * north * north * this->inv_meridian
+                + 0.5 * east * east * this->inv_prime_vertical;
+            lla[i].altitude_mm = alt_m * 1000; // m to mm
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        Eigen::Vector3d ecef = this->ned_to_ecef(ned[i]);
+        double alt_m;
+        ecef_to_geodetic(ecef[0], ecef[1], ecef[2], lla[i].latitude_deg, lla[i].longitude_deg, alt_m);
+        lla[i].altitude_mm = alt_m * 1000; // m to mm
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef __LOCALGEODETICFRAME_H__
+#define __LOCALGEODETICFRAME_H__
+
+#include <stddef.h>
+#include <Eigen/Eigen>
+#include "../DataStructures/LatLonAlt.h"
+
+enum GeodeticAccuracy {
+    // NED -> ECEF -> geodetic (same results as ned_to_ecef + ecef_to_geodetic)
+    EXACT,
+    // Second order local tangent plane expansion, no trig per point.
+    // Horizontal error < 1 mm within 1 km of the origin, ~0.1 m at 10 km (vertical ~1 mm)
+    FLAT_EARTH
+};
+
+/**
+ * North-East-Down frame tangent to the WGS84 ellipsoid at a fixed origin.
+ *
+ * Everything that only depends on the origin (ECEF position, NED -> ECEF rotation,
+ * radii of curvature) is computed once, on construction. The frame is immutable,
+ * so a single instance can convert positions for any number of vehicles concurrently.
+ */
+class LocalGeodeticFrame {
+private:
+    LatLonAlt origin;
+    double origin_lat_rad;
+    double origin_lon_rad;
+    double origin_alt_m;
+    Eigen::Vector3d origin_ecef;
+    Eigen::Matrix3d ned2ecef;
+    // Flat earth terms: inverse meridian / prime vertical radii at the origin altitude
+    double inv_meridian;
+    double inv_prime_vertical;
+    double tan_lat;
+    double sec_lat;
+public:
+    LocalGeodeticFrame(const LatLonAlt& origin);
+
+    const LatLonAlt& get_origin() const { return this->origin; }
+
+    Eigen::Vector3d ned_to_ecef(const Eigen::Vector3d& ned) const;
+    LatLonAlt ned_to_lla(const Eigen::Vector3d& ned, GeodeticAccuracy accuracy = EXACT) const;
+    // Batched conversion of `n` NED positions (m)
+    void ned_to_lla(const Eigen::Vector3d* ned, LatLonAlt* lla, size_t n, GeodeticAccuracy accuracy = EXACT) const;
+};
+
+#endif // __LOCALGEODETICFRAME_H__
@@ -7,7 +7,7 @@
 #include "constants.h"
 
 
-void ned_to_ecef(double lat0, double lon0, double h0, Eigen::VectorXd& state, double& x, double& y, double& z) {
+inline void ned_to_ecef(double lat0, double lon0, double h0, Eigen::VectorXd& state, double& x, double& y, double& z) {
 
     double xEast = state[1];
     double yNorth = state[0];
@@ -37,7 +37,7 @@ void ned_to_ecef(double lat0, double lon0, double h0, Eigen::VectorXd& state, do
     z = zd + z0;
 }
 
-void ecef_to_geodetic(double x, double y, double z,
+inline void ecef_to_geodetic(double x, double y, double z,
                                     double& lat, double& lon, double& h)
 {
     double p = sqrt(x * x + y * y);
@@ -1,30 +1,27 @@
-#include <stdio.h>
-#include <stdlib.h>
 #include <time.h>
-#include <list>
-#include <string>
-#include <iomanip>
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <cstdlib>
-#include "../Logging/ConsoleLogger.h"
 #include "magnetic_field_lookup.h"
-#include "../MagneticModel/WMM.h"
+#include "../MagneticModel/WMMEngine.h"
 
-static Eigen::VectorXd* cached_magfield = NULL;
+#define NT_TO_GAUSS 1e-5
 
-Eigen::VectorXd magnetic_field_for_latlonalt(LatLonAlt lat_lon_alt) {
-    if (cached_magfield != NULL) return *cached_magfield;
-    geomag_vector now;
-    time_t my_time;
-    struct tm * timeinfo; 
-    time (&my_time);
-    timeinfo = localtime (&my_time);
-    WorldMagneticModel(&now, lat_lon_alt.latitude_deg, lat_lon_alt.longitude_deg, lat_lon_alt.altitude_mm / 1000000.0, timeinfo->tm_year+1900);// Lat, Lon, Alt, Time
-    cached_magfield = new Eigen::VectorXd(3);
-    (*cached_magfield)[0] = now.X * 1e-5;
-    (*cached_magfield)[1] = now.Y * 1e-5;
-    (*cached_magfield)[2] = now.Z * 1e-5;
-    return *cached_magfield;
-}
\ No newline at end of file
+/**
+ * Secular variation is negligible over a run, so the date is taken once.
+ */
+double current_decimal_year() {
+    static const double decimal_year = []() {
+        time_t now = time(NULL);
+        struct tm timeinfo;
+        localtime_r(&now, &timeinfo);
+        return timeinfo.tm_year + 1900 + timeinfo.tm_yday / 365.25;
+    }();
+    return decimal_year;
+}
+
+Eigen::Vector3d magnetic_field_for_latlonalt(const LatLonAlt& lat_lon_alt) {
+    return WMMEngine::shared_instance().field(
+        lat_lon_alt.latitude_deg,
+        lat_lon_alt.longitude_deg,
+        lat_lon_alt.altitude_mm / 1000000.0, // mm to km
+        current_decimal_year()
+    ) * NT_TO_GAUSS;
+}
@@ -4,6 +4,10 @@
 #include <Eigen/Eigen>
 #include "../DataStructures/LatLonAlt.h"
 
-Eigen::VectorXd magnetic_field_for_latlonalt(LatLonAlt lat_lon_alt);
+// Date of the simulation run as a decimal year (taken once)
+double current_decimal_year();
 
-#endif // __MAGNETIC_FIELD_LOOKUP_H__
\ No newline at end of file
+// Earth frame (NED) magnetic field in gauss at the given position, for the current date
+Eigen::Vector3d magnetic_field_for_latlonalt(const LatLonAlt& lat_lon_alt);
+
+#endif // __MAGNETIC_FIELD_LOOKUP_H__
@@ -0,0 +1,47 @@
+#include "IMUIntegrator.h"
+
+IMUIntegrator::IMUIntegrator(double rate_hz) {
+    this->interval = rate_hz > 0 ? 1.0 / rate_hz : 0;
+}
+
+bool IMUIntegrator::integrate(double dt, const Eigen::Vector3d& body_rates, const Eigen::Vector3d& specific_force) {
+    if (dt <= 0) return false;
+    if (!this->has_last) {
+        this->last_rate = body_rates;
+        this->last_force = specific_force;
+        this->has_last = true;
+    }
+
+    // Increments over the step (trapezoidal)
+    Eigen::Vector3d alpha = 0.5 * (this->last_rate + body_rates) * dt;
+    Eigen::Vector3d nu = 0.5 * (this->last_force + specific_force) * dt;
+
+    // Coning: rotation of the rotation vector within the interval
+    this->coning += 0.5 * (this->delta_angle + this->last_alpha / 6.0).cross(alpha);
+    // Sculling: rotation of the velocity increments within the interval
+    this->sculling += 0.5 * (this->delta_angle.cross(nu) + this->delta_velocity.cross(alpha)) +
+        (this->last_alpha.cross(nu) + this->last_nu.cross(alpha)) / 12.0;
+
+    this->delta_angle += alpha;
+    this->delta_velocity += nu;
+    this->elapsed += dt;
+
+    this->last_rate = body_rates;
+    this->last_force = specific_force;
+    this->last_alpha = alpha;
+    this->last_nu = nu;
+
+    if (this->elapsed < this->interval - 1e-9) return false;
+
+    this->output_delta_angle = this->delta_angle + this->coning;
+    this->output_delta_velocity = this->delta_velocity + 0.5 * this->delta_angle.cross(this->delta_velocity) + this->sculling;
+    this->angular_rate = this->output_delta_angle / this->elapsed;
+    this->specific_force = this->output_delta_velocity / this->elapsed;
+
+    this->delta_angle.setZero();
+    this->delta_velocity.setZero();
+    this->coning.setZero();
+    this->sculling.setZero();
+    this->elapsed = 0;
+    return true;
+}
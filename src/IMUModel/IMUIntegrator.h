@@ -0,0 +1,56 @@
+#ifndef __IMUINTEGRATOR_H__
+#define __IMUINTEGRATOR_H__
+
+#include <Eigen/Eigen>
+
+/**
+ * Strapdown IMU front end: accumulates delta-angle and delta-velocity at the
+ * physics rate and emits their averages at the IMU rate, with the coning
+ * (delta-angle) and sculling / rotation (delta-velocity) corrections of a
+ * two-sample algorithm, so that fast attitude motion within an IMU interval
+ * is not lost by the slower output.
+ */
+class IMUIntegrator {
+private:
+    double interval = 0;        // s, 0: one output per physics step
+    double elapsed = 0;
+
+    // Accumulated over the current IMU interval
+    Eigen::Vector3d delta_angle{0, 0, 0};
+    Eigen::Vector3d delta_velocity{0, 0, 0};
+    Eigen::Vector3d coning{0, 0, 0};
+    Eigen::Vector3d sculling{0, 0, 0};
+
+    // Previous physics step
+    Eigen::Vector3d last_rate{0, 0, 0};
+    Eigen::Vector3d last_force{0, 0, 0};
+    Eigen::Vector3d last_alpha{0, 0, 0};
+    Eigen::Vector3d last_nu{0, 0, 0};
+    bool has_last = false;
+
+    // Outputs of the last completed IMU interval
+    Eigen::Vector3d angular_rate{0, 0, 0};
+    Eigen::Vector3d specific_force{0, 0, 0};
+    Eigen::Vector3d output_delta_angle{0, 0, 0};
+    Eigen::Vector3d output_delta_velocity{0, 0, 0};
+
+public:
+    IMUIntegrator(double rate_hz = 0);
+
+    /**
+     * Integrates one physics step.
+     * @param dt                physics step (s)
+     * @param body_rates        body frame angular rate at the end of the step (rad/s)
+     * @param specific_force    body frame specific force at the end of the step (m/s**2)
+     * @return true when an IMU interval completed and the outputs were updated
+     */
+    bool integrate(double dt, const Eigen::Vector3d& body_rates, const Eigen::Vector3d& specific_force);
+
+    // Averages over the last IMU interval
+    const Eigen::Vector3d& get_angular_rate() const { return this->angular_rate; }
+    const Eigen::Vector3d& get_specific_force() const { return this->specific_force; }
+    const Eigen::Vector3d& get_delta_angle() const { return this->output_delta_angle; }
+    const Eigen::Vector3d& get_delta_velocity() const { return this->output_delta_velocity; }
+};
+
+#endif // __IMUINTEGRATOR_H__
@@ -9,7 +9,8 @@
 #include "../DataStructures/LatLonAlt.h"
 #include "../DataStructures/GPSData.h"
 #include "../DataStructures/GroundSpeed.h"
-#include <random>
+#include "../DataStructures/SensorFrame.h"
+#include "../PowerModel/Battery.h"
 #include <algorithm>
 #include <assert.h> 
 #include <cmath>
@@ -24,42 +25,10 @@
 
 class DroneStateEncoder {
 private:
-    // Standard deviations for sensor noise
-    float noise_Acc = 0.001f;
-    float noise_Gps = 10.0f;
-    float noise_Gyo = 0.001f;
-    float noise_Mag = 0.000001f;
-    float noise_Prs = 0.001f;
-
-    double random_walk_gps_x = 0;
-    double random_walk_gps_y = 0;
-    double random_walk_gps_z = 0;
-    double gps_correlation_time = 30.0;
-
-    std::random_device rd; 
-    std::mt19937 gen{rd()}; 
-
-    std::normal_distribution<double> nd_acc{0, noise_Acc};
-    std::normal_distribution<double> nd_gyo{0, noise_Gyo};
-    std::normal_distribution<double> nd_mag{0, noise_Mag};
-    std::normal_distribution<double> nd_prs{0, noise_Prs};
-    std::normal_distribution<double> nd_gps{0, noise_Gps};
-
-    void update_random_walk_gps(boost::chrono::microseconds us) {
-        double dt = (us.count() / 1000000.0);
-        double sqrtDt = sqrt(dt);
-        double noiseX = sqrtDt * this->nd_gps(this->gen);
-        double noiseY = sqrtDt * this->nd_gps(this->gen);
-        double noiseZ = sqrtDt * this->nd_gps(this->gen);
-
-        this->random_walk_gps_x += noiseX * dt - this->random_walk_gps_x / gps_correlation_time;
-        this->random_walk_gps_y += noiseY * dt - this->random_walk_gps_y / gps_correlation_time;
-        this->random_walk_gps_z += noiseZ * dt - this->random_walk_gps_z / gps_correlation_time;
-    }
-
-    mavlink_message_t _battery_status_msg(
+    void _battery_status_msg(
             uint8_t system_id,
             uint8_t component_id,
+            mavlink_message_t& msg,
             uint8_t battery_id,
             uint8_t  battery_function,
             uint8_t battery_type,
@@ -70,7 +39,6 @@ private:
             int32_t energy_consumed,
             int8_t battery_remaining_percent
         ) {
-            mavlink_message_t msg;
             const uint16_t voltages[10] = {battery_voltage, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX, UINT16_MAX};
             const uint16_t additional_voltages[4] = {0, 0, 0, 0};
 
@@ -93,12 +61,12 @@ private:
                 0,
                 0 // no fault
             );
-            return msg;
         }
 
-    mavlink_message_t _hil_sensor_msg(
+    void _hil_sensor_msg(
         uint8_t system_id,
         uint8_t component_id,
+        mavlink_message_t& msg,
         float x_acc,
         float y_acc,
         float z_acc,
@@ -115,8 +83,6 @@ private:
         uint32_t fields_updated = 0b1101111111111
     )
     {
-        mavlink_message_t msg;
-
 #ifdef HIL_SENSOR_VERBOSE
         printf("[HIL_SENSOR]\n");
         printf("Body frame Acceleration (m/s**2): %f %f %f \n", x_acc, y_acc, z_acc);
@@ -168,13 +134,12 @@ private:
             fields_updated,
             0 // ID
         );
-
-        return msg;
     }
 
-    mavlink_message_t _hil_state_quaternion_msg(
+    void _hil_state_quaternion_msg(
         uint8_t system_id,
         uint8_t component_id,
+        mavlink_message_t& msg,
         float* attitude_quaternion,
         float roll_speed,
         float pitch_speed,
@@ -191,7 +156,6 @@ private:
         int16_t y_acc,
         int16_t z_acc) 
     {
-        mavlink_message_t msg;
 #ifdef HIL_STATE_QUATERNION_VERBOSE
         Eigen::VectorXd attitude_euler = this->get_sensors().get_earth_frame_attitude();
 
@@ -246,8 +210,6 @@ assert(z_acc == z_acc);
             y_acc,
             z_acc
         );
-        
-        return msg;
     }
 
 protected:
@@ -256,46 +218,45 @@ public:
     virtual uint64_t get_sim_time() = 0;
     virtual Sensors& get_sensors() = 0;
     
-    virtual Eigen::VectorXd get_state() = 0;
-    virtual Eigen::VectorXd get_dx_state() = 0;
+    virtual const Eigen::VectorXd& get_state() = 0;
+    virtual const Eigen::VectorXd& get_dx_state() = 0;
 
-    // THIS IS CURRENTLY UNUSED -- Battery is broadcasted from python probe system
-    
-    mavlink_message_t battery_status_msg(uint8_t system_id, uint8_t component_id) {
+    /**
+     * The encoders below pack straight into the caller's message,
+     * reading every sensor quantity from a frame sampled once per tick.
+     */
+
+    void battery_status_msg(const BatteryState& battery, uint8_t system_id, uint8_t component_id, mavlink_message_t& msg) {
         uint8_t battery_id = 0;
         uint8_t battery_function = 1; // MAV_BATTERY_FUNCTION_ALL
-        uint8_t battery_type = 3; // MAV_BATTERY_TYPE_LION
-        int16_t battery_temperature = 25; // cDegC
-        uint16_t battery_voltage = 5000; // mV
-        uint8_t battery_remaining_percent = 100;
+        uint8_t battery_type = 1; // MAV_BATTERY_TYPE_LIPO
 
-        return this->_battery_status_msg(
+        this->_battery_status_msg(
             system_id,
             component_id,
+            msg,
             battery_id,
             battery_function,
             battery_type,
-            battery_temperature,
-            battery_voltage,
-            -1,
-            -1, 
-            -1,
-            battery_remaining_percent
+            (int16_t)std::lround(battery.temperature * 100), // cdegC
+            (uint16_t)std::min(std::lround(battery.voltage * 1000), (long)UINT16_MAX - 1), // mV
+            (int16_t)std::min(std::lround(battery.current * 100), (long)INT16_MAX), // cA
+            (int32_t)std::lround(battery.consumed_mah), // mAh
+            (int32_t)std::lround(battery.consumed_energy / 100), // hJ
+            (int8_t)std::lround(battery.remaining * 100)
         );
     }
 
-    mavlink_message_t hil_state_quaternion_msg(uint8_t system_id, uint8_t component_id) {
-        Sensors& sensors = this->get_sensors();
-
-        Eigen::VectorXd attitude = euler_angles_to_quaternions(sensors.get_earth_frame_attitude());
+    void hil_state_quaternion_msg(const SensorFrame& frame, uint8_t system_id, uint8_t component_id, mavlink_message_t& msg) {
+        Eigen::VectorXd attitude = euler_angles_to_quaternions(frame.earth_attitude);
         float attitude_float[4] = {0};
         for (int i = 0; i < attitude.size(); i++) attitude_float[i] = attitude[i];
 
-        Eigen::Vector3d angle_rates = sensors.get_earth_frame_angle_rates();
-        LatLonAlt lat_lon_alt = sensors.get_lat_lon_alt();
-        Eigen::Vector3d ground_speed = sensors.get_absolute_ground_speed() * 100; // m to cm
-        Eigen::Vector3d body_frame_acc = caelus_fdm::body2earth(this->get_state()) * sensors.get_body_frame_acceleration();
-        uint16_t true_wind_speed = sensors.get_true_wind_speed();
+        const Eigen::Vector3d& angle_rates = frame.earth_angle_rates;
+        const LatLonAlt& lat_lon_alt = frame.lat_lon_alt;
+        Eigen::Vector3d ground_speed = frame.ground_speed * 100; // m to cm
+        Eigen::Vector3d body_frame_acc = frame.body2earth * frame.body_acceleration;
+        uint16_t true_wind_speed = frame.true_wind_speed;
 
         // TODO REMOVE -- ITS A TEST
         float gforce = 9.81;
@@ -306,11 +267,10 @@ public:
         body_frame_acc[1] = (int16_t)std::round((body_frame_acc[1] / fabs(gforce)) * 1000);
         body_frame_acc[2] = (int16_t)std::round((body_frame_acc[2] / fabs(gforce)) * 1000);
 
-        // std::cout << body_frame_acc[2] << "  " << sensors.get_body_frame_acceleration()[2] << std::endl;
-
-        return this->_hil_state_quaternion_msg(
+        this->_hil_state_quaternion_msg(
             system_id,
             component_id,
+            msg,
             attitude_float,
             angle_rates[0],
             angle_rates[1],
@@ -329,56 +289,42 @@ public:
         );
     }
 
-    mavlink_message_t hil_sensor_msg(uint8_t system_id, uint8_t component_id) {
-        Sensors& sensors = this->get_sensors();
-        
-        LatLonAlt lat_lon_alt = sensors.get_lat_lon_alt();
+    void hil_sensor_msg(const SensorFrame& frame, uint8_t system_id, uint8_t component_id, mavlink_message_t& msg) {
+        const LatLonAlt& lat_lon_alt = frame.lat_lon_alt;
         // m/s**2
-        Eigen::Vector3d body_frame_acc = sensors.get_body_frame_acceleration();
-        body_frame_acc = caelus_fdm::body2earth(this->get_state()) * body_frame_acc;
-        body_frame_acc[2] -= G_FORCE;
-        body_frame_acc[2] = std::min(body_frame_acc[2], -9.81);
-        body_frame_acc = caelus_fdm::earth2body(this->get_state()) * body_frame_acc;
-
+        const Eigen::Vector3d& body_frame_acc = frame.accelerometer;
         // rad/s
-        Eigen::Vector3d gyro_xyz = sensors.get_body_frame_gyro();
+        const Eigen::Vector3d& gyro_xyz = frame.gyroscope;
         // gauss
-        Eigen::Vector3d magfield = sensors.get_magnetic_field();
-        double abs_pressure = sensors.get_pressure() / 100; // Pa to hPa
-        double temperature = sensors.get_environment_temperature();
+        const Eigen::Vector3d& magfield = frame.magnetometer;
+        double abs_pressure = frame.barometer_pressure / 100; // Pa to hPa
+        double temperature = frame.thermometer_temperature;
         float diff_pressure = 0;
 
-        return this->_hil_sensor_msg(
+        this->_hil_sensor_msg(
             system_id,
             component_id, 
-            body_frame_acc[0] + this->nd_acc(this->gen),
-            body_frame_acc[1] + this->nd_acc(this->gen),
-            body_frame_acc[2] + this->nd_acc(this->gen),
-            gyro_xyz[0] + this->nd_gyo(this->gen),
-            gyro_xyz[1] + this->nd_gyo(this->gen),
-            gyro_xyz[2] + this->nd_gyo(this->gen),
-            magfield[0] + this->nd_mag(this->gen),
-            magfield[1] + this->nd_mag(this->gen),
-            magfield[2] + this->nd_mag(this->gen),
-            abs_pressure + this->nd_prs(this->gen) / 100,
-            diff_pressure + this->nd_prs(this->gen) / 100,
-            -lat_lon_alt.altitude_mm / 1000 + this->nd_prs(this->gen) / 1000 , 
-            temperature + this->nd_prs(this->gen)
+            msg,
+            body_frame_acc[0],
+            body_frame_acc[1],
+            body_frame_acc[2],
+            gyro_xyz[0],
+            gyro_xyz[1],
+            gyro_xyz[2],
+            magfield[0],
+            magfield[1],
+            magfield[2],
+            abs_pressure,
+            diff_pressure,
+            -lat_lon_alt.altitude_mm / 1000, 
+            temperature
         );
     }
 
-    mavlink_message_t hil_gps_msg(uint8_t system_id, uint8_t component_id) {
-        Sensors& sensors = this->get_sensors();
-        mavlink_message_t msg;
-
-        GPSData gps_data = sensors.get_gps_data();
-        GroundSpeed gs = gps_data.ground_speed;
-        LatLonAlt lat_lon_alt = gps_data.lat_lon_alt;
-        
-        this->update_random_walk_gps(boost::chrono::microseconds{4000});
-        gps_data.lat_lon_alt.latitude_deg += random_walk_gps_x;
-        gps_data.lat_lon_alt.longitude_deg += random_walk_gps_y;
-        gps_data.lat_lon_alt.altitude_mm += random_walk_gps_z / 1000;
+    void hil_gps_msg(const SensorFrame& frame, uint8_t system_id, uint8_t component_id, mavlink_message_t& msg) {
+        const GPSData& gps_data = frame.gps_data;
+        const GroundSpeed& gs = gps_data.ground_speed;
+        const LatLonAlt& lat_lon_alt = gps_data.lat_lon_alt;
 
 #ifdef HIL_GPS_VERBOSE
         printf("[GPS SENSOR]\n");
@@ -386,7 +332,7 @@ public:
         printf("EPH EPV (dimensionless): %d %d \n", gps_data.eph, gps_data.epv);
         printf("Ground speed (cm/s): %d %d %d \n", gs.north_speed, gs.east_speed, gs.down_speed);
         printf("GPS ground speed (m/s): %d\n", gps_data.gps_ground_speed);
-        printf("Course over ground: %d (x.%f y.%f) \n",  gps_data.course_over_ground, sensors.get_earth_frame_velocity()[0], sensors.get_earth_frame_velocity()[1]);
+        printf("Course over ground: %d (x.%f y.%f) \n",  gps_data.course_over_ground, frame.earth_velocity[0], frame.earth_velocity[1]);
         printf("Sats visible: %d \n",  gps_data.satellites_visible);
         printf("Vehicle yaw (deg): %d \n",  gps_data.vehicle_yaw);
         printf("Sim time %llu\n", this->get_sim_time());
@@ -418,22 +364,18 @@ assert(gps_data.vehicle_yaw == gps_data.vehicle_yaw);
             lat_lon_alt.altitude_mm,
             gps_data.eph,
             gps_data.epv,
-            gps_data.gps_ground_speed + this->nd_acc(this->gen),
-            gs.north_speed + this->nd_acc(this->gen),
-            gs.east_speed + this->nd_acc(this->gen),
-            gs.down_speed + this->nd_acc(this->gen),
+            gps_data.gps_ground_speed,
+            gs.north_speed,
+            gs.east_speed,
+            gs.down_speed,
             gps_data.course_over_ground,
             gps_data.satellites_visible,
             0, // ID
             gps_data.vehicle_yaw
         );
-
-        return msg;
     }
 
-    mavlink_message_t system_time_msg(uint8_t system_id, uint8_t component_id) {
-        mavlink_message_t msg;
-
+    void system_time_msg(uint8_t system_id, uint8_t component_id, mavlink_message_t& msg) {
         uint64_t time_unix_usec = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::system_clock::now().time_since_epoch()).count();
         uint32_t time_boot_ms = this->get_sim_time() / 1000; // us to ms
 
@@ -444,8 +386,6 @@ assert(gps_data.vehicle_yaw == gps_data.vehicle_yaw);
             time_unix_usec,
             time_boot_ms
         );
-
-        return msg;
     }
 };
 
@@ -2,23 +2,35 @@
 #define __DYNAMICOBJECT_H__
 
 #include <array>
+#include <memory>
 #include <Eigen/Eigen>
 #include <boost/numeric/odeint.hpp>
 #include <random>
 
 #include "EnvironmentObject.h"
 #include "../ClassExtensions/Aerodynamics_Extension.h"
-#include "../ForceModels/ThrustQuadrotor.h"
+#include "../ForceModels/ThrustMultirotor.h"
 #include "../ForceModels/Drag.h"
 #include "../ForceModels/Weight.h"
 #include "../ClassExtensions/ThrustFixedWing_Extension.h"
 #include "../Helpers/constants.h"
 #include "../Helpers/angleRateRotationMatrix.h"
+#include "../Helpers/rotationMatrix.h"
+#include "../WindModel/WindService.h"
+#include "../TerrainModel/Terrain.h"
+#include "../ContactModel/GroundContact.h"
+#include "../RotorModel/RotorDynamics.h"
+#include "../PowerModel/Battery.h"
+#include "../PowerModel/PropulsionPower.h"
+#include "../AtmosphereModel/ISAAtmosphere.h"
+#include "../Profiling/TickProfiler.h"
 #include "Clock.h"
 
 typedef boost::numeric::odeint::runge_kutta_dopri5<Eigen::VectorXd,double,Eigen::VectorXd,double,boost::numeric::odeint::vector_space_algebra> ODESolver;
 
 #define DYNAMIC_OBJECT_STATE_SIZE 12
+// Rotors of the default (quad X) layout
+#define DYNAMIC_OBJECT_VTOL_ROTORS 4
 #define ZEROVEC(x) Eigen::VectorXd::Zero(x)
 
 
@@ -37,17 +49,39 @@ struct DynamicObject : public EnvironmentObject {
 
 protected:
 
-    double ground_height = 0;
-    
-    DroneConfig config;
+    // Shared with every vehicle built from the same file (see ConfigRegistry)
+    std::shared_ptr<const DroneConfig> shared_config;
+    const DroneConfig& config;
 
     caelus_fdm::Weight weight_force_m;
     ThrustFixedWing fixed_wing_thrust_m;
-    caelus_fdm::ThrustQuadrotor quadrotor_thrust_m;
+    ThrustMultirotor multirotor_thrust_m;
     caelus_fdm::Drag drag_m;
     Aerodynamics hor_flight_aero_force_m;
     Clock& clock;
 
+    // Landing gear against the terrain, evaluated at every integration stage
+    std::shared_ptr<const Terrain> terrain;
+    GroundContact ground_contact;
+
+    // Motor lag of the VTOL rotors, whose speeds are integrated with the state
+    RotorDynamics rotor_dynamics;
+    RotorIntegration rotor_integration = EXPONENTIAL_ROTORS;
+    std::function<Eigen::VectorXd(double)> vtol_controller;
+    // Rotor speeds at the start of the step, for the exact (exponential) solution
+    double step_start_time = 0;
+    Eigen::VectorXd step_start_rotor_speeds;
+    Eigen::VectorXd stage_rotor_speeds;
+
+    // Drained by the propulsion load, its voltage sag limits what the motors deliver
+    Battery battery;
+
+    // Shared wind environment, the vehicle sees no wind without one
+    WindService* wind_service = NULL;
+    std::unique_ptr<TurbulenceModel> turbulence;
+    // Wind (NED, m/s) at the vehicle, sampled once per tick
+    Eigen::Vector3d wind{0, 0, 0};
+
     ODESolver dynamics_solver;
     
     bool compute_quadrotor_dynamics = true;
@@ -55,6 +89,7 @@ protected:
     bool compute_aero_dynamics = false;
     bool compute_weight_dynamics = true;
     bool compute_drag_dynamics = true;
+    bool compute_ground_contact = true;
 
     Eigen::Matrix3d moment_of_inertia;
      
@@ -65,6 +100,7 @@ protected:
      *  u, v, w      [3:6]  body-frame velocity (Body Fixed) (m/s)
      *  ɸ , θ , ѱ    [6:9]  (roll, pitch, yaw) angular position (Earth Fixed) (rad)
      *  p, q, r      [9:12] Angular velocity (Body Fixed) (rad/s)
+     *  ω1 ... ωn    [12:]  VTOL rotor speeds (rad/s)
      * >
      */
     Eigen::VectorXd state{DYNAMIC_OBJECT_STATE_SIZE};
@@ -75,24 +111,46 @@ protected:
      *  u., v., w.      [3:6]  linear acceleration (Bpdy Fixed) (m/s**2)
      *  ɸ. , θ. , ѱ.    [6:9]  angular velocity (Earth Fixed) (NED) (rad/s)
      *  p. , q. , r.    [9:12] angular acceleration (Body Fixed) (rad/s**2)
+     *  ω1. ... ωn.     [12:]  rotor acceleration (rad/s**2), zero when integrated exactly
      */
     Eigen::VectorXd dx_state{DYNAMIC_OBJECT_STATE_SIZE};
 
+    void rotor_speeds_at(const Eigen::VectorXd& state, double t, Eigen::VectorXd& speeds) {
+        if (this->rotor_integration == EXPONENTIAL_ROTORS)
+            this->rotor_dynamics.propagate(this->step_start_rotor_speeds, t - this->step_start_time, speeds);
+        else
+            speeds = state.tail(this->rotor_dynamics.size());
+    }
+
     void step_dynamics(
         boost::chrono::microseconds us,
         const Eigen::VectorXd& state,
-        Eigen::VectorXd& dx_state) {
+        Eigen::VectorXd& dx_state,
+        double t) {
+
+        // Rotor thrust follows the rotor speeds of the stage
+        if (this->compute_quadrotor_dynamics) {
+            this->rotor_speeds_at(state, t, this->stage_rotor_speeds);
+            this->multirotor_thrust_m.setRotorSpeeds(t, state, this->stage_rotor_speeds);
+        }
         
         Eigen::Vector3d total_forces = this->get_forces();
         Eigen::Vector3d total_momenta = this->get_moements();
 
         Eigen::Vector3d Vb = state.segment(3,3);
         Eigen::Vector3d wb = state.segment(9,3);
+        Eigen::Matrix3d body2earth = caelus_fdm::body2earth(state);
 
-        dx_state = Eigen::VectorXd::Zero(12);
+        // Contact depends on the stage state, unlike the per tick force models
+        if (this->compute_ground_contact) {
+            ProfileScope scope(PROFILE_GROUND_CONTACT);
+            this->ground_contact.add_forces(state, body2earth, *this->terrain, total_forces, total_momenta);
+        }
+
+        dx_state = Eigen::VectorXd::Zero(state.size());
 
         // Linear velocity in earth frame
-        dx_state.segment(0,3) = caelus_fdm::body2earth(state)*Vb;
+        dx_state.segment(0,3) = body2earth*Vb;
         // Linear acceleration
         dx_state.segment(3,3)  = total_forces/this->weight_force_m.get_mass(); // external forces
         dx_state.segment(3,3) -= wb.cross(Vb.eval()); // account for frame dependent acc
@@ -108,58 +166,102 @@ protected:
         // inertia matrix into account
         dx_state.segment(9,3)  = this->moment_of_inertia.colPivHouseholderQr().solve(dx_state.segment(9,3).eval()); 
 
+        // Rotor speeds (constant for the solver when integrated exactly)
+        if (this->rotor_integration == EXPLICIT_ROTORS)
+            this->rotor_dynamics.derivative(state.tail(this->rotor_dynamics.size()), dx_state.tail(this->rotor_dynamics.size()));
+
         // Remove numerical noise < 1e-12
         for (auto i = 0; i < dx_state.size(); i++)
             dx_state[i] = fabs(dx_state[i]) < 1e-12 ? 0 : dx_state[i];
     }
 
     void integration_step(boost::chrono::microseconds us) {
+        ProfileScope scope(PROFILE_INTEGRATION);
         // Integrate using ODESolver
         double dt = us.count() / 1000000.0; // Microseconds to seconds
+        double t = this->clock.get_current_time_us().count() / 1000000.0;
+        const int rotors = this->rotor_dynamics.size();
+        if (this->rotor_integration == EXPONENTIAL_ROTORS) {
+            this->step_start_time = t;
+            this->step_start_rotor_speeds = this->state.tail(rotors);
+        }
         this->dynamics_solver.do_step(
-            [this, us] (const Eigen::VectorXd & x, Eigen::VectorXd &dx, __attribute__((unused)) const double t ) -> void
+            [this, us] (const Eigen::VectorXd & x, Eigen::VectorXd &dx, const double t ) -> void
             {
-                this->step_dynamics(us, x, dx);
+                this->step_dynamics(us, x, dx, t);
             },
             this->state,
             this->dx_state,
-            this->clock.get_current_time_us().count() / 1000000.0, // Simulation time here in seconds?
+            t,
             dt
         );
+        if (this->rotor_integration == EXPONENTIAL_ROTORS)
+            this->rotor_dynamics.propagate(this->step_start_rotor_speeds, dt, this->state.tail(rotors));
+    }
+
+    // Electrical power drawn by the propellers (W) at the current state
+    double propulsion_power() {
+        double rho = ISAAtmosphere::shared_instance().at(-this->state[2]).density;
+        Eigen::Vector3d airspeed = this->state.segment<3>(3) - caelus_fdm::earth2body(this->state) * this->wind;
+        double power = 0;
+        if (this->compute_quadrotor_dynamics) {
+            for (int i = 0; i < this->rotor_dynamics.size(); i++) {
+                const RotorConfig& rotor = this->config.rotors[i];
+                double omega = this->state[DYNAMIC_OBJECT_STATE_SIZE + i];
+                power += propeller_electrical_power(rotor.thrust_coefficient * omega * omega, airspeed.dot(rotor.axis), rho, this->config.battery);
+            }
+        }
+        if (this->compute_fixed_wing_dynamics)
+            power += propeller_electrical_power(this->fixed_wing_thrust_m.getF()[0], airspeed[0], rho, this->config.battery);
+        return power;
     }
 
     void initialise_state() {
-        this->state = Eigen::VectorXd::Zero(DYNAMIC_OBJECT_STATE_SIZE);
+        this->state = Eigen::VectorXd::Zero(DYNAMIC_OBJECT_STATE_SIZE + this->rotor_dynamics.size());
     }
 
     void initialise_dx_state() {
-        this->dx_state = Eigen::VectorXd::Zero(DYNAMIC_OBJECT_STATE_SIZE);
+        this->dx_state = Eigen::VectorXd::Zero(DYNAMIC_OBJECT_STATE_SIZE + this->rotor_dynamics.size());
     }
 
 public:
 
-    DynamicObject(DroneConfig config, Clock& clock) : 
-        config(config),
-        weight_force_m(caelus_fdm::Weight{config, G_FORCE}),
-        fixed_wing_thrust_m(ThrustFixedWing{config}),
-        quadrotor_thrust_m(caelus_fdm::ThrustQuadrotor{config}),
-        hor_flight_aero_force_m(Aerodynamics{config}),
-        drag_m(caelus_fdm::Drag{config}),
-        clock(clock)
+    DynamicObject(std::shared_ptr<const DroneConfig> config, Clock& clock) : 
+        shared_config(config),
+        config(*this->shared_config),
+        weight_force_m(caelus_fdm::Weight{*config, G_FORCE}),
+        fixed_wing_thrust_m(ThrustFixedWing{*config}),
+        multirotor_thrust_m(ThrustMultirotor{*config}),
+        hor_flight_aero_force_m(Aerodynamics{*config}),
+        drag_m(caelus_fdm::Drag{*config}),
+        clock(clock),
+        terrain(std::make_shared<FlatTerrain>()),
+        ground_contact(config->landing_gear),
+        rotor_dynamics(config->rotors.size(), config->vtol_tau),
+        stage_rotor_speeds(Eigen::VectorXd::Zero(config->rotors.size())),
+        battery(config->battery)
         {
             this->initialise_state();
             this->initialise_dx_state();
-            this->moment_of_inertia = config.J;
+            this->moment_of_inertia = config->J;
         };
 
+    // Private copy of `config`
+    DynamicObject(const DroneConfig& config, Clock& clock) :
+        DynamicObject(std::make_shared<const DroneConfig>(config), clock) {}
+
     ~DynamicObject() {};
 
+    const DroneConfig& get_config() const { return this->config; }
+    std::shared_ptr<const DroneConfig> get_shared_config() const { return this->shared_config; }
+    boost::chrono::microseconds get_current_time_us() { return this->clock.get_current_time_us(); }
+
     Eigen::VectorXd& get_vector_state() { return this->state; }
     Eigen::VectorXd& get_vector_dx_state() { return this->dx_state; }
     
     Eigen::Vector3d get_forces() {
         Eigen::Vector3d fixed_wing_force = this->compute_fixed_wing_dynamics ? this->fixed_wing_thrust_m.getF() : ZEROVEC(3);
-        Eigen::Vector3d quadrotor_force = this->compute_quadrotor_dynamics ? this->quadrotor_thrust_m.getF() : ZEROVEC(3);
+        Eigen::Vector3d quadrotor_force = this->compute_quadrotor_dynamics ? this->multirotor_thrust_m.getF() : ZEROVEC(3);
         Eigen::Vector3d aero_force = this->compute_aero_dynamics ? this->hor_flight_aero_force_m.getF() : ZEROVEC(3);
         Eigen::Vector3d weight_force = this->compute_weight_dynamics ? this->weight_force_m.getF() : ZEROVEC(3);
         Eigen::Vector3d drag_force = this->compute_drag_dynamics ? this->drag_m.getF() : ZEROVEC(3);
@@ -168,7 +270,7 @@ public:
 
     Eigen::Vector3d get_moements() {
         Eigen::Vector3d fixed_wing_moment = this->compute_fixed_wing_dynamics ? this->fixed_wing_thrust_m.getM() : ZEROVEC(3);
-        Eigen::Vector3d quadrotor_moment = this->compute_quadrotor_dynamics ? this->quadrotor_thrust_m.getM() : ZEROVEC(3);
+        Eigen::Vector3d quadrotor_moment = this->compute_quadrotor_dynamics ? this->multirotor_thrust_m.getM() : ZEROVEC(3);
         Eigen::Vector3d aero_moment = this->compute_aero_dynamics ? this->hor_flight_aero_force_m.getM() : ZEROVEC(3);
         Eigen::Vector3d weight_moment = this->compute_weight_dynamics ? this->weight_force_m.getM() : ZEROVEC(3);
         Eigen::Vector3d drag_moment = this->compute_drag_dynamics ? this->drag_m.getM() : ZEROVEC(3);
@@ -176,33 +278,94 @@ public:
         return fixed_wing_moment + quadrotor_moment + aero_moment + weight_moment + drag_moment;
     }
 
+    void update_wind(boost::chrono::microseconds us) {
+        if (this->wind_service == NULL) return;
+        Eigen::Vector3d position = this->state.segment<3>(0);
+        this->wind = this->wind_service->wind_at(position);
+        if (this->turbulence) {
+            double dt = us.count() / 1000000.0;
+            double airspeed = (this->state.segment<3>(3) - caelus_fdm::earth2body(this->state) * this->wind).norm();
+            const Eigen::Vector3d& gust = this->turbulence->step(dt, airspeed, -position[2] - this->terrain->elevation_at(position[0], position[1]));
+            this->wind += caelus_fdm::body2earth(this->state) * gust;
+        }
+    }
+
     void update(boost::chrono::microseconds us) override {
+        this->update_force_models(us);
+        this->integration_step(us);
+        this->battery.step(us.count() / 1000000.0, this->propulsion_power());
+    }
+
+    // Per tick force models, the stage dependent ones are evaluated during integration
+    void update_force_models(boost::chrono::microseconds us) {
+        ProfileScope scope(PROFILE_FORCE_MODELS);
         Eigen::VectorXd state = this->get_vector_state();
+        this->update_wind(us);
+        this->drag_m.setWind(this->wind);
+        this->hor_flight_aero_force_m.setWind(this->wind);
         if (this->compute_fixed_wing_dynamics)
             this->fixed_wing_thrust_m.updateParamsImpl(0,state);
-        if (this->compute_quadrotor_dynamics)
-            this->quadrotor_thrust_m.updateParamsImpl(0,state);
+        if (this->compute_quadrotor_dynamics && this->vtol_controller)
+            this->rotor_dynamics.set_command(this->vtol_controller(0) * this->battery.voltage_ratio());
         if (this->compute_aero_dynamics)
-            this->hor_flight_aero_force_m.updateParamsImpl(0,state);
+            // Simulation time paces the stall warnings
+            this->hor_flight_aero_force_m.updateParamsImpl(this->clock.get_current_time_us().count() / 1000000.0, state);
         if (this->compute_weight_dynamics)
             this->weight_force_m.updateParamsImpl(0,state);
-        this->integration_step(us);
+        if (this->compute_drag_dynamics)
+            this->drag_m.updateParamsImpl(0,state);
     }
 
+    // Commanded rotor speeds at full charge, reached through the motor lag
     void setControllerVTOL(std::function<Eigen::VectorXd(double)> controller) {
-        this->quadrotor_thrust_m.setController(controller);
+        this->vtol_controller = controller;
+    }
+
+    void set_rotor_integration(RotorIntegration integration) {
+        this->rotor_integration = integration;
     }
 
+    Eigen::VectorXd get_rotor_speeds() const { return this->state.tail(this->rotor_dynamics.size()); }
+
     void setControllerThrust(std::function<Eigen::VectorXd(double)> controller) {
-        this->fixed_wing_thrust_m.setController(controller);
+        // Propeller speed follows the battery voltage
+        this->fixed_wing_thrust_m.setController([this, controller](double t) -> Eigen::VectorXd {
+            return controller(t) * this->battery.voltage_ratio();
+        });
     }
 
     void setControllerAero(std::function<Eigen::VectorXd(double)> controller) {
         this->hor_flight_aero_force_m.setController(controller);
     }
 
+    void set_wind_service(WindService& wind_service) {
+        this->wind_service = &wind_service;
+        this->turbulence = wind_service.make_turbulence();
+    }
+
+    const Eigen::Vector3d& get_wind() const { return this->wind; }
+
+    const BatteryState& get_battery_state() const { return this->battery.get_state(); }
+
+    // Aerodynamics evaluations that clamped the angle of attack (linear model only)
+    uint64_t get_aero_stall_count() { return this->hor_flight_aero_force_m.getStallCount(); }
+
+    /**
+     * Sets the ground the landing gear touches. A vehicle sitting
+     * below it is lifted to rest on it.
+     */
+    void set_terrain(std::shared_ptr<const Terrain> terrain) {
+        this->terrain = terrain;
+        double ground_down = -terrain->elevation_at(this->state[0], this->state[1]);
+        double resting_down = this->ground_contact.resting_down_position(ground_down, this->config.mass);
+        if (this->compute_ground_contact && this->state[2] > resting_down) this->state[2] = resting_down;
+    }
+
+    const Terrain& get_terrain() const { return *this->terrain; }
+
+    // Flat ground at `level` (m, NED down)
     void set_fake_ground_level(double level) {
-        this->ground_height = level;
+        this->set_terrain(std::make_shared<FlatTerrain>(-level));
     }
 };
 
@@ -8,8 +8,11 @@ class MAVLinkMessageRelay {
 public:
     virtual bool received_message(mavlink_message_t m) = 0;
     virtual bool send_message(const mavlink_message_t& m) = 0;
-    virtual void enqueue_message(const mavlink_message_t m) = 0;
+    virtual void enqueue_message(const mavlink_message_t& m) = 0;
+    // Subscribes the handler to every message
     virtual void add_message_handler(MAVLinkMessageHandler* h) = 0;
+    // Subscribes the handler to the messages with the given id only
+    virtual void add_message_handler(MAVLinkMessageHandler* h, uint32_t msgid) = 0;
     virtual bool connection_open() = 0;
 };
 
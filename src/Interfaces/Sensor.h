@@ -1,10 +1,120 @@
 #ifndef __SENSOR_H__
 #define __SENSOR_H__
 
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+#include <Eigen/Eigen>
+#include "../Containers/SensorsConfig.h"
+
+/**
+ * Measurement pipeline of a sensor with a fixed size Eigen vector output T:
+ * bias random walk, scale factor, vibration and white noise, sampled at the
+ * sensor rate and delivered after its transport delay.
+ *
+ * Normal draws are not generated here: each update consumes NOISE_SIZE of
+ * them from a batch shared by all the sensors of a vehicle (see SensorNoise).
+ */
 template<class T>
 class Sensor {
 public:
+    static const int SIZE = T::RowsAtCompileTime;
+    // Standard normal draws consumed per update (white noise, bias walk)
+    static const int NOISE_SIZE = 2 * SIZE;
+
+private:
+    struct Sample {
+        double time;
+        T value;
+    };
+
+    SensorConfig config;
+    T bias = T::Zero();
+    T output = T::Zero();
+    std::deque<Sample> in_transit;
+    double last_time = NAN;
+    double next_sample_time = 0;
+    bool has_output = false;
+
+public:
+    Sensor(const SensorConfig& config = SensorConfig()) : config(config) {}
+
+    /**
+     * @param t       simulation time (s), the bias walks over the real elapsed time
+     * @param truth   true value of the measured quantity
+     * @param noise   NOISE_SIZE standard normal draws
+     * @return true when a new measurement was delivered
+     */
+    bool update(double t, const T& truth, const double* noise) {
+        double dt = std::isnan(this->last_time) ? 0 : t - this->last_time;
+        this->last_time = t;
+
+        Eigen::Map<const T> white(noise);
+        Eigen::Map<const T> walk(noise + SIZE);
+        if (dt > 0 && this->config.bias_walk > 0) {
+            // First order Gauss-Markov, pure random walk without a correlation time
+            if (this->config.bias_correlation_time > 0) {
+                this->bias -= this->bias * std::min(1.0, dt / this->config.bias_correlation_time);
+            }
+            this->bias += walk * (this->config.bias_walk * std::sqrt(dt));
+        }
+
+        if (this->config.rate_hz <= 0 || t >= this->next_sample_time) {
+            T measurement = truth * this->config.scale + this->bias + white * this->config.noise;
+            if (this->config.vibration_amplitude > 0) {
+                // Same frequency on every axis, phases 120 deg apart
+                double phase = 2 * M_PI * this->config.vibration_frequency * t;
+                for (int i = 0; i < SIZE; i++) {
+                    measurement[i] += this->config.vibration_amplitude * std::sin(phase + i * 2 * M_PI / 3);
+                }
+            }
+            this->in_transit.push_back(Sample{t, measurement});
+            if (this->config.rate_hz > 0) {
+                this->next_sample_time += 1.0 / this->config.rate_hz;
+                if (this->next_sample_time <= t) this->next_sample_time = t + 1.0 / this->config.rate_hz;
+            }
+        }
+
+        // Deliver the newest measurement older than the transport delay
+        bool delivered = false;
+        while (!this->in_transit.empty() && this->in_transit.front().time <= t - this->config.delay + 1e-9) {
+            this->output = this->in_transit.front().value;
+            this->in_transit.pop_front();
+            delivered = true;
+        }
+        // Nothing has made it through the delay yet: report the oldest sample
+        if (delivered) this->has_output = true;
+        else if (!this->has_output && !this->in_transit.empty()) this->output = this->in_transit.front().value;
+        return delivered;
+    }
+
+    const T& get() const { return this->output; }
+    const T& get_bias() const { return this->bias; }
+    const SensorConfig& get_config() const { return this->config; }
+};
+
+typedef Sensor<Eigen::Vector3d> Sensor3d;
+typedef Sensor<Eigen::Matrix<double, 1, 1>> Sensor1d;
+
+/**
+ * Standard normal draws for every sensor of a vehicle, generated
+ * as a single batch per tick and sliced between the sensors.
+ */
+class SensorNoise {
+private:
+    std::mt19937 gen;
+    std::normal_distribution<double> nd{0, 1};
+    std::vector<double> draws;
+public:
+    SensorNoise(size_t size, uint32_t seed = 0) : draws(size) {
+        this->gen.seed(seed != 0 ? seed : std::random_device{}());
+    }
 
-};  
+    const double* draw() {
+        for (double& d : this->draws) d = this->nd(this->gen);
+        return this->draws.data();
+    }
+};
 
-#endif // __SENSOR_H__
\ No newline at end of file
+#endif // __SENSOR_H__
@@ -5,6 +5,7 @@
 #include "../DataStructures/LatLonAlt.h"
 #include "../DataStructures/GroundSpeed.h"
 #include "../DataStructures/GPSData.h"
+#include "../DataStructures/SensorFrame.h"
 
 class Sensors {
 public:
@@ -48,6 +49,8 @@ public:
     virtual Eigen::Vector3d get_environment_wind() = 0;
     // Temperature in [degC]
     virtual double get_environment_temperature() = 0;
+    // Samples every quantity above for the current tick in one pass
+    virtual void sample_frame(SensorFrame& frame) = 0;
 };
 
 
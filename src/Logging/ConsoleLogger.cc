@@ -1,12 +1,9 @@
 #include <string>
 #include "ConsoleLogger.h"
 
-ConsoleLogger* ConsoleLogger::instance{nullptr};
-std::mutex ConsoleLogger::mutex;
-
 ConsoleLogger* ConsoleLogger::shared_instance() {
-    std::lock_guard<std::mutex> lock(mutex);
-    if (instance == nullptr) instance = new ConsoleLogger();
+    // Thread-safe one-time initialisation, no lock on the (hot) lookup path
+    static ConsoleLogger* instance = new ConsoleLogger();
     return instance;
 }
 
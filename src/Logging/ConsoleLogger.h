@@ -2,16 +2,13 @@
 #define __CONSOLELOGGER_H__
 
 #include <string>
-#include <mutex>
 #include "../Interfaces/Logger.h"
 
 enum LoggerMode { NORMAL, DEBUG };
 
 class ConsoleLogger : public Logger {
 private:
-    static ConsoleLogger* instance;
-    static std::mutex mutex;
-    LoggerMode log_mode;
+    LoggerMode log_mode = LoggerMode::NORMAL;
 protected:
     ConsoleLogger() {};
     ~ConsoleLogger() {};
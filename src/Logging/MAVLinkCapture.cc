@@ -0,0 +1,93 @@
+#include <string.h>
+#include <boost/chrono.hpp>
+#include "MAVLinkCapture.h"
+
+MAVLinkCaptureWriter::MAVLinkCaptureWriter(const char* path, Clock& clock) : clock(clock) {
+    this->file = fopen(path, "wb");
+    if (this->file == NULL) {
+        fprintf(stderr, "Could not open MAVLink capture file %s\n", path);
+        return;
+    }
+    char magic[8] = MAVLINK_CAPTURE_MAGIC;
+    uint32_t version = MAVLINK_CAPTURE_VERSION;
+    fwrite(magic, sizeof(magic), 1, this->file);
+    fwrite(&version, sizeof(version), 1, this->file);
+}
+
+MAVLinkCaptureWriter::~MAVLinkCaptureWriter() {
+    if (this->file != NULL) fclose(this->file);
+}
+
+void MAVLinkCaptureWriter::record(MAVLinkCaptureDirection direction, const mavlink_message_t& m) {
+    if (this->file == NULL) return;
+
+    uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+    uint16_t frame_len = mavlink_msg_to_send_buffer(frame, &m);
+    uint8_t dir = direction;
+    uint64_t sim_time_us = this->clock.get_current_time_us().count();
+    uint64_t wall_time_us = boost::chrono::duration_cast<boost::chrono::microseconds>(
+        boost::chrono::system_clock::now().time_since_epoch()
+    ).count();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    fwrite(&dir, sizeof(dir), 1, this->file);
+    fwrite(&sim_time_us, sizeof(sim_time_us), 1, this->file);
+    fwrite(&wall_time_us, sizeof(wall_time_us), 1, this->file);
+    fwrite(&frame_len, sizeof(frame_len), 1, this->file);
+    fwrite(frame, frame_len, 1, this->file);
+    // Keep the capture usable if the simulator is interrupted
+    if (++this->frames_written % MAVLINK_CAPTURE_FLUSH_INTERVAL == 0) fflush(this->file);
+}
+
+void MAVLinkCaptureWriter::flush() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->file != NULL) fflush(this->file);
+}
+
+std::vector<MAVLinkCaptureRecord> MAVLinkCaptureReader::read_all(const char* path) {
+    std::vector<MAVLinkCaptureRecord> records;
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Could not open MAVLink capture file %s\n", path);
+        return records;
+    }
+
+    char magic[8] = {0};
+    uint32_t version = 0;
+    if (fread(magic, sizeof(magic), 1, file) != 1 ||
+        fread(&version, sizeof(version), 1, file) != 1 ||
+        strncmp(magic, MAVLINK_CAPTURE_MAGIC, sizeof(magic)) != 0 ||
+        version != MAVLINK_CAPTURE_VERSION) {
+        fprintf(stderr, "Invalid header in MAVLink capture file %s\n", path);
+        fclose(file);
+        return records;
+    }
+
+    uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+    while (true) {
+        uint8_t dir;
+        uint16_t frame_len;
+        MAVLinkCaptureRecord record;
+        if (fread(&dir, sizeof(dir), 1, file) != 1 ||
+            fread(&record.sim_time_us, sizeof(record.sim_time_us), 1, file) != 1 ||
+            fread(&record.wall_time_us, sizeof(record.wall_time_us), 1, file) != 1 ||
+            fread(&frame_len, sizeof(frame_len), 1, file) != 1) break;
+        if (frame_len > MAVLINK_MAX_PACKET_LEN || fread(frame, frame_len, 1, file) != 1) break;
+        record.direction = (MAVLinkCaptureDirection)dir;
+
+        // Private parser state -- must not interfere with the live link channels
+        mavlink_message_t rx_buffer;
+        mavlink_status_t rx_status;
+        mavlink_status_t status;
+        memset(&rx_buffer, 0, sizeof(rx_buffer));
+        memset(&rx_status, 0, sizeof(rx_status));
+        bool decoded = false;
+        for (auto i = 0; i < frame_len && !decoded; i++) {
+            decoded = mavlink_frame_char_buffer(&rx_buffer, &rx_status, frame[i], &record.message, &status) == MAVLINK_FRAMING_OK;
+        }
+        if (decoded) records.push_back(record);
+    }
+
+    fclose(file);
+    return records;
+}
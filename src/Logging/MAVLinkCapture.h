@@ -0,0 +1,66 @@
+#ifndef __MAVLINKCAPTURE_H__
+#define __MAVLINKCAPTURE_H__
+
+#include <mavlink.h>
+#include <stdio.h>
+#include <mutex>
+#include <vector>
+#include "../Interfaces/Clock.h"
+
+/**
+ * Binary MAVLink capture format.
+ *
+ * Header:  "6DOFCAP" magic (8 bytes, NUL terminated) + uint32 version
+ * Record:  uint8  direction (see MAVLinkCaptureDirection)
+ *          uint64 simulation time (us)
+ *          uint64 wall time (us since unix epoch)
+ *          uint16 frame length
+ *          frame  (MAVLink wire format, as produced by mavlink_msg_to_send_buffer)
+ *
+ * All integers are stored in host byte order.
+ */
+#define MAVLINK_CAPTURE_MAGIC "6DOFCAP"
+#define MAVLINK_CAPTURE_VERSION 1
+#define MAVLINK_CAPTURE_FLUSH_INTERVAL 1024 // frames
+
+enum MAVLinkCaptureDirection : uint8_t { INBOUND = 0, OUTBOUND = 1 };
+
+struct MAVLinkCaptureRecord {
+    MAVLinkCaptureDirection direction;
+    uint64_t sim_time_us;
+    uint64_t wall_time_us;
+    mavlink_message_t message;
+};
+
+/**
+ * Appends MAVLink frames to a capture file.
+ * Frames can be recorded from both the network thread (inbound)
+ * and the simulation thread (outbound).
+ */
+class MAVLinkCaptureWriter {
+private:
+    FILE* file = NULL;
+    Clock& clock;
+    std::mutex mutex;
+    uint64_t frames_written = 0;
+public:
+    MAVLinkCaptureWriter(const char* path, Clock& clock);
+    ~MAVLinkCaptureWriter();
+    MAVLinkCaptureWriter(MAVLinkCaptureWriter& w) = delete;
+
+    bool is_open() { return this->file != NULL; }
+    uint64_t get_frames_written() { return this->frames_written; }
+    void record(MAVLinkCaptureDirection direction, const mavlink_message_t& m);
+    void flush();
+};
+
+class MAVLinkCaptureReader {
+public:
+    /**
+     * Loads every record of a capture file.
+     * Frames that fail to decode (e.g. truncated tail of an interrupted capture) are skipped.
+     */
+    static std::vector<MAVLinkCaptureRecord> read_all(const char* path);
+};
+
+#endif // __MAVLINKCAPTURE_H__
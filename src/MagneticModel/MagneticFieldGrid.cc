@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "MagneticFieldGrid.h"
+
+/**
+ * Header a cache file must carry to be reused for this spec.
+ * Zero initialised so that the padding fields compare equal.
+ */
+static MagneticGridFileHeader header_for(const MagneticGridSpec& spec, double wmm_epoch) {
+    MagneticGridFileHeader header;
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, MAGNETIC_GRID_MAGIC, sizeof(header.magic));
+    header.version = MAGNETIC_GRID_VERSION;
+    header.wmm_epoch = wmm_epoch;
+    header.center_lat_deg = spec.center.latitude_deg;
+    header.center_lon_deg = spec.center.longitude_deg;
+    header.decimal_year = spec.decimal_year;
+    header.lat_span_deg = spec.lat_span_deg;
+    header.lon_span_deg = spec.lon_span_deg;
+    header.alt_min_m = spec.alt_min_m;
+    header.alt_max_m = spec.alt_max_m;
+    header.lat_points = spec.lat_points;
+    header.lon_points = spec.lon_points;
+    header.alt_points = spec.alt_points;
+    return header;
+}
+
+MagneticFieldGrid::MagneticFieldGrid(const MagneticGridSpec& spec, const WMMEngine& engine, const char* cache_path) :
+    spec(spec),
+    engine(engine)
+    {
+        // Interpolation needs at least one cell per axis
+        this->spec.lat_points = std::max(this->spec.lat_points, 2u);
+        this->spec.lon_points = std::max(this->spec.lon_points, 2u);
+        this->spec.alt_points = std::max(this->spec.alt_points, 2u);
+
+        this->lat_min = this->spec.center.latitude_deg - this->spec.lat_span_deg / 2;
+        this->lon_min = this->spec.center.longitude_deg - this->spec.lon_span_deg / 2;
+        this->alt_min = this->spec.alt_min_m;
+        this->lat_step_inv = (this->spec.lat_points - 1) / this->spec.lat_span_deg;
+        this->lon_step_inv = (this->spec.lon_points - 1) / this->spec.lon_span_deg;
+        this->alt_step_inv = (this->spec.alt_points - 1) / (this->spec.alt_max_m - this->spec.alt_min_m);
+
+        if (cache_path != NULL && this->_map_cache(cache_path)) return;
+
+        this->_build();
+        if (cache_path != NULL) this->_write_cache(cache_path);
+    }
+
+MagneticFieldGrid::~MagneticFieldGrid() {
+    if (this->mapping != NULL) munmap(this->mapping, this->mapping_size);
+}
+
+std::shared_ptr<const MagneticFieldGrid> MagneticFieldGrid::shared_grid(const MagneticGridSpec& spec, const char* cache_path) {
+    static std::mutex mutex;
+    static std::vector<std::pair<MagneticGridFileHeader, std::weak_ptr<const MagneticFieldGrid>>> grids;
+
+    const WMMEngine& engine = WMMEngine::shared_instance();
+    MagneticGridFileHeader key = header_for(spec, engine.get_epoch());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : grids) {
+        if (memcmp(&entry.first, &key, sizeof(key)) != 0) continue;
+        if (auto grid = entry.second.lock()) return grid;
+    }
+    auto grid = std::make_shared<const MagneticFieldGrid>(spec, engine, cache_path);
+    grids.push_back({key, grid});
+    return grid;
+}
+
+size_t MagneticFieldGrid::_node_count() const {
+    return (size_t)this->spec.lat_points * this->spec.lon_points * this->spec.alt_points;
+}
+
+#pragma mark BUILDING
+
+void MagneticFieldGrid::_build() {
+    const uint32_t lat_points = this->spec.lat_points;
+    const uint32_t lon_points = this->spec.lon_points;
+    const size_t rows = (size_t)this->spec.alt_points * lat_points;
+    this->owned_nodes.resize(this->_node_count() * 3);
+    float* out = this->owned_nodes.data();
+
+    // Each worker fills every n-th (alt, lat) row of nodes
+    auto build_rows = [this, out, rows, lat_points, lon_points](size_t first, size_t stride) {
+        for (size_t row = first; row < rows; row += stride) {
+            double alt_m = this->alt_min + (row / lat_points) / this->alt_step_inv;
+            double lat = this->lat_min + (row % lat_points) / this->lat_step_inv;
+            for (uint32_t i = 0; i < lon_points; i++) {
+                double lon = this->lon_min + i / this->lon_step_inv;
+                Eigen::Vector3d f = this->engine.field(lat, lon, alt_m / 1000.0, this->spec.decimal_year);
+                float* node = out + (row * lon_points + i) * 3;
+                node[0] = f[0];
+                node[1] = f[1];
+                node[2] = f[2];
+            }
+        }
+    };
+
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, rows);
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; w++) threads.emplace_back(build_rows, w, workers);
+    build_rows(0, workers);
+    for (auto& t : threads) t.join();
+
+    this->nodes = out;
+}
+
+#pragma mark DISK_CACHE
+
+bool MagneticFieldGrid::_map_cache(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    size_t expected_size = sizeof(MagneticGridFileHeader) + this->_node_count() * 3 * sizeof(float);
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != expected_size) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, expected_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+
+    MagneticGridFileHeader expected = header_for(this->spec, this->engine.get_epoch());
+    if (memcmp(mapping, &expected, sizeof(expected)) != 0) {
+        // Stale cache (different origin, box or model): rebuilt by the caller
+        munmap(mapping, expected_size);
+        return false;
+    }
+
+    this->mapping = mapping;
+    this->mapping_size = expected_size;
+    this->nodes = (const float*)((const char*)mapping + sizeof(MagneticGridFileHeader));
+    return true;
+}
+
+void MagneticFieldGrid::_write_cache(const char* path) {
+    // Written aside and renamed so that concurrent readers never map a partial file
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Could not write magnetic grid cache %s\n", path);
+        return;
+    }
+    MagneticGridFileHeader header = header_for(this->spec, this->engine.get_epoch());
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(this->owned_nodes.data(), sizeof(float), this->owned_nodes.size(), file) == this->owned_nodes.size();
+    fclose(file);
+
+    if (!ok || rename(tmp_path.c_str(), path) != 0) {
+        fprintf(stderr, "Could not write magnetic grid cache %s\n", path);
+        remove(tmp_path.c_str());
+    }
+}
+
+#pragma mark LOOKUP
+
+bool MagneticFieldGrid::contains(const LatLonAlt& lat_lon_alt) const {
+    double fx = (lat_lon_alt.latitude_deg - this->lat_min) * this->lat_step_inv;
+    double fy = (lat_lon_alt.longitude_deg - this->lon_min) * this->lon_step_inv;
+    double fz = (lat_lon_alt.altitude_mm / 1000.0 - this->alt_min) * this->alt_step_inv;
+    return fx >= 0 && fx <= this->spec.lat_points - 1 &&
+        fy >= 0 && fy <= this->spec.lon_points - 1 &&
+        fz >= 0 && fz <= this->spec.alt_points - 1;
+}
+
+Eigen::Vector3d MagneticFieldGrid::field(const LatLonAlt& lat_lon_alt) const {
+    if (!this->contains(lat_lon_alt)) {
+        return this->engine.field(
+            lat_lon_alt.latitude_deg,
+            lat_lon_alt.longitude_deg,
+            lat_lon_alt.altitude_mm / 1000000.0, // mm to km
+            this->spec.decimal_year
+        );
+    }
+
+    double fx = (lat_lon_alt.latitude_deg - this->lat_min) * this->lat_step_inv;
+    double fy = (lat_lon_alt.longitude_deg - this->lon_min) * this->lon_step_inv;
+    double fz = (lat_lon_alt.altitude_mm / 1000.0 - this->alt_min) * this->alt_step_inv;
+    // Upper edge of the box belongs to the last cell
+    uint32_t ix = std::min((uint32_t)fx, this->spec.lat_points - 2);
+    uint32_t iy = std::min((uint32_t)fy, this->spec.lon_points - 2);
+    uint32_t iz = std::min((uint32_t)fz, this->spec.alt_points - 2);
+    double tx = fx - ix, ty = fy - iy, tz = fz - iz;
+
+    const size_t lon_stride = 3;
+    const size_t lat_stride = (size_t)this->spec.lon_points * lon_stride;
+    const size_t alt_stride = (size_t)this->spec.lat_points * lat_stride;
+    const float* c000 = this->nodes + iz * alt_stride + ix * lat_stride + iy * lon_stride;
+
+    Eigen::Vector3d result;
+    for (int k = 0; k < 3; k++) {
+        const float* c = c000 + k;
+        double c00 = c[0] + ty * (c[lon_stride] - c[0]);
+        double c10 = c[lat_stride] + ty * (c[lat_stride + lon_stride] - c[lat_stride]);
+        double c01 = c[alt_stride] + ty * (c[alt_stride + lon_stride] - c[alt_stride]);
+        double c11 = c[alt_stride + lat_stride] + ty * (c[alt_stride + lat_stride + lon_stride] - c[alt_stride + lat_stride]);
+        double c0 = c00 + tx * (c10 - c00);
+        double c1 = c01 + tx * (c11 - c01);
+        result[k] = c0 + tz * (c1 - c0);
+    }
+    return result;
+}
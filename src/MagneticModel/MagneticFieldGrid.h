@@ -0,0 +1,100 @@
+#ifndef __MAGNETICFIELDGRID_H__
+#define __MAGNETICFIELDGRID_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <vector>
+#include <Eigen/Eigen>
+#include "../DataStructures/LatLonAlt.h"
+#include "WMMEngine.h"
+
+/**
+ * Binary magnetic grid cache format.
+ *
+ * Header:  MagneticGridFileHeader ("6DOFMAG" magic, version, WMM epoch, grid spec)
+ * Body:    float[3] (north, east, down in nT) per node, longitude fastest, then latitude, then altitude
+ *
+ * All values are stored in host byte order; the file is mapped as is.
+ */
+#define MAGNETIC_GRID_MAGIC "6DOFMAG"
+#define MAGNETIC_GRID_VERSION 1
+
+/**
+ * Lat/lon/alt box sampled by the grid, centered on `center` horizontally.
+ * Altitudes are absolute (WGS84, m).
+ */
+struct MagneticGridSpec {
+    LatLonAlt center;
+    double decimal_year;
+    double lat_span_deg = 2.0;
+    double lon_span_deg = 2.0;
+    double alt_min_m = -500.0;
+    double alt_max_m = 10000.0;
+    uint32_t lat_points = 21;
+    uint32_t lon_points = 21;
+    uint32_t alt_points = 11;
+};
+
+struct MagneticGridFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    double wmm_epoch;
+    double center_lat_deg;
+    double center_lon_deg;
+    double decimal_year;
+    double lat_span_deg;
+    double lon_span_deg;
+    double alt_min_m;
+    double alt_max_m;
+    uint32_t lat_points;
+    uint32_t lon_points;
+    uint32_t alt_points;
+    uint32_t reserved2;
+};
+
+/**
+ * Precomputed WMM field over a MagneticGridSpec box, queried with trilinear interpolation.
+ *
+ * The nodes are evaluated once, in parallel. When a cache path is given, a cache
+ * matching the spec is memory mapped instead of being rebuilt, and a fresh build is
+ * written back to it. Positions outside the box fall back to a full WMM evaluation.
+ */
+class MagneticFieldGrid {
+private:
+    MagneticGridSpec spec;
+    const WMMEngine& engine;
+
+    double lat_min, lon_min, alt_min;
+    double lat_step_inv, lon_step_inv, alt_step_inv;
+
+    // Either points into `owned_nodes` or into the mapped cache file
+    const float* nodes = NULL;
+    std::vector<float> owned_nodes;
+    void* mapping = NULL;
+    size_t mapping_size = 0;
+
+    size_t _node_count() const;
+    void _build();
+    bool _map_cache(const char* path);
+    void _write_cache(const char* path);
+public:
+    MagneticFieldGrid(const MagneticGridSpec& spec, const WMMEngine& engine, const char* cache_path = NULL);
+    ~MagneticFieldGrid();
+    MagneticFieldGrid(MagneticFieldGrid& g) = delete;
+
+    /**
+     * Grid shared by every caller asking for the same spec (e.g. vehicles with a common origin).
+     */
+    static std::shared_ptr<const MagneticFieldGrid> shared_grid(const MagneticGridSpec& spec, const char* cache_path = NULL);
+
+    const MagneticGridSpec& get_spec() const { return this->spec; }
+    bool is_memory_mapped() const { return this->mapping != NULL; }
+    bool contains(const LatLonAlt& lat_lon_alt) const;
+
+    // Magnetic field (north, east, down) in nT
+    Eigen::Vector3d field(const LatLonAlt& lat_lon_alt) const;
+};
+
+#endif // __MAGNETICFIELDGRID_H__
@@ -27,6 +27,7 @@ void WorldMagneticModel(geomag_vector *inout, double dlat,double dlon,double alt
 //dlon is LONGITUDE (IN DECIMAL DEGREES): East longitude positive & West negative. (i.e.- 100.0 for 100.0 degrees west.)
 //altm is ALTITUDE (IN KILOMETERS): ABOVE WGS84 ELLIPSOID.
 //time (IN DECIMAL YEAR): 2015 - 2020
+//Thin wrapper over WMMEngine::shared_instance(), safe to call from several threads.
 
 
 
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "WMMEngine.h"
+
+// WGS84 ellipsoid and geomagnetic reference radius (km)
+#define WMM_A 6378.137
+#define WMM_B 6356.7523142
+#define WMM_RE 6371.2
+#define WMM_DEG_TO_RAD (M_PI / 180.0)
+#define WMM_N (WMM_MAX_DEGREE + 1)
+
+WMMEngine::WMMEngine(const char* coefficients_path) {
+    this->_load_coefficients(coefficients_path);
+    this->_normalize_coefficients();
+}
+
+const WMMEngine& WMMEngine::shared_instance() {
+    static WMMEngine instance;
+    return instance;
+}
+
+#pragma mark LOADING
+
+void WMMEngine::_load_coefficients(const char* path) {
+    char line[81];
+    char model[20];
+    int n, m;
+    double gnm, hnm, dgnm, dhnm;
+
+    FILE* cof = fopen(path, "r");
+    if (cof == NULL) {
+        fprintf(stderr, "Error opening model file %s\n", path);
+        exit(1);
+    }
+
+    if (fgets(line, 80, cof) == NULL || sscanf(line, "%lf%19s", &this->epoch, model) < 2) {
+        fprintf(stderr, "Invalid header in model file %s\n", path);
+        exit(1);
+    }
+
+    while (fgets(line, 80, cof) != NULL) {
+        // Coefficient list is terminated by a line of 9s
+        if (strncmp(line, "9999", 4) == 0) break;
+        if (sscanf(line, "%d%d%lf%lf%lf%lf", &n, &m, &gnm, &hnm, &dgnm, &dhnm) < 6) continue;
+        if (n > WMM_MAX_DEGREE) break;
+        if (m > n || m < 0) {
+            fprintf(stderr, "Corrupt record in model file %s\n", path);
+            exit(1);
+        }
+        this->c[m][n] = gnm;
+        this->cd[m][n] = dgnm;
+        if (m != 0) {
+            this->c[n][m-1] = hnm;
+            this->cd[n][m-1] = dhnm;
+        }
+    }
+    fclose(cof);
+}
+
+/**
+ * Converts the Schmidt semi-normalised coefficients to unnormalised ones
+ * and precomputes the Legendre recursion constants.
+ */
+void WMMEngine::_normalize_coefficients() {
+    double snorm[WMM_N][WMM_N] = {{0}};
+    snorm[0][0] = 1.0;
+
+    for (int n = 1; n <= WMM_MAX_DEGREE; n++) {
+        snorm[0][n] = snorm[0][n-1] * (double)(2*n - 1) / (double)n;
+        int j = 2;
+        for (int m = 0; m <= n; m++) {
+            this->k[m][n] = (double)((n-1)*(n-1) - m*m) / (double)((2*n - 1) * (2*n - 3));
+            if (m > 0) {
+                double flnmj = (double)((n - m + 1) * j) / (double)(n + m);
+                snorm[m][n] = snorm[m-1][n] * sqrt(flnmj);
+                j = 1;
+                this->c[n][m-1] *= snorm[m][n];
+                this->cd[n][m-1] *= snorm[m][n];
+            }
+            this->c[m][n] *= snorm[m][n];
+            this->cd[m][n] *= snorm[m][n];
+        }
+        this->fn[n] = (double)(n + 1);
+        this->fm[n] = (double)n;
+    }
+    this->k[1][1] = 0.0;
+}
+
+#pragma mark EVALUATION
+
+Eigen::Vector3d WMMEngine::field(double lat_deg, double lon_deg, double alt_km, double decimal_year) const {
+    const double a2 = WMM_A * WMM_A;
+    const double b2 = WMM_B * WMM_B;
+    const double c2 = a2 - b2;
+    const double a4 = a2 * a2;
+    const double c4 = a4 - b2 * b2;
+
+    double dt = decimal_year - this->epoch;
+    double rlon = lon_deg * WMM_DEG_TO_RAD;
+    double rlat = lat_deg * WMM_DEG_TO_RAD;
+    double srlat = sin(rlat);
+    double crlat = cos(rlat);
+    double srlat2 = srlat * srlat;
+    double crlat2 = crlat * crlat;
+
+    // Geodetic to spherical coordinates
+    double q = sqrt(a2 - c2 * srlat2);
+    double q1 = alt_km * q;
+    double q2 = ((q1 + a2) / (q1 + b2)) * ((q1 + a2) / (q1 + b2));
+    double ct = srlat / sqrt(q2 * crlat2 + srlat2);
+    double st = sqrt(1.0 - ct * ct);
+    double r = sqrt(alt_km * alt_km + 2.0 * q1 + (a4 - c4 * srlat2) / (q * q));
+    double d = sqrt(a2 * crlat2 + b2 * srlat2);
+    double ca = (alt_km + d) / r;
+    double sa = c2 * crlat * srlat / (r * d);
+
+    // sin / cos of m * lon
+    double sp[WMM_N], cp[WMM_N];
+    sp[0] = 0.0;
+    cp[0] = 1.0;
+    sp[1] = sin(rlon);
+    cp[1] = cos(rlon);
+    for (int m = 2; m <= WMM_MAX_DEGREE; m++) {
+        sp[m] = sp[1] * cp[m-1] + cp[1] * sp[m-1];
+        cp[m] = cp[1] * cp[m-1] - sp[1] * sp[m-1];
+    }
+
+    // Associated Legendre polynomials and their derivatives, indexed [m][n]
+    double p[WMM_N][WMM_N] = {{0}};
+    double dp[WMM_N][WMM_N] = {{0}};
+    double pp[WMM_N] = {0};
+    p[0][0] = 1.0;
+    pp[0] = 1.0;
+
+    double aor = WMM_RE / r;
+    double ar = aor * aor;
+    double br = 0, bt = 0, bp = 0, bpp = 0;
+
+    for (int n = 1; n <= WMM_MAX_DEGREE; n++) {
+        ar *= aor;
+        for (int m = 0; m <= n; m++) {
+            if (n == m) {
+                p[m][n] = st * p[m-1][n-1];
+                dp[m][n] = st * dp[m-1][n-1] + ct * p[m-1][n-1];
+            } else if (n == 1 && m == 0) {
+                p[m][n] = ct * p[m][n-1];
+                dp[m][n] = ct * dp[m][n-1] - st * p[m][n-1];
+            } else {
+                double p_n2 = m > n - 2 ? 0.0 : p[m][n-2];
+                double dp_n2 = m > n - 2 ? 0.0 : dp[m][n-2];
+                p[m][n] = ct * p[m][n-1] - this->k[m][n] * p_n2;
+                dp[m][n] = ct * dp[m][n-1] - st * p[m][n-1] - this->k[m][n] * dp_n2;
+            }
+
+            // Time adjusted Gauss coefficients
+            double g = this->c[m][n] + dt * this->cd[m][n];
+            double h = m != 0 ? this->c[n][m-1] + dt * this->cd[n][m-1] : 0.0;
+
+            double par = ar * p[m][n];
+            double temp1 = g * cp[m] + h * sp[m];
+            double temp2 = g * sp[m] - h * cp[m];
+
+            bt -= ar * temp1 * dp[m][n];
+            bp += this->fm[m] * temp2 * par;
+            br += this->fn[n] * temp1 * par;
+
+            // North / south geographic poles
+            if (st == 0.0 && m == 1) {
+                pp[n] = n == 1 ? pp[n-1] : ct * pp[n-1] - this->k[m][n] * pp[n-2];
+                bpp += this->fm[m] * temp2 * ar * pp[n];
+            }
+        }
+    }
+    bp = st == 0.0 ? bpp : bp / st;
+
+    // Spherical to geodetic field components
+    return Eigen::Vector3d(
+        -bt * ca - br * sa,
+        bp,
+        bt * sa - br * ca
+    );
+}
@@ -0,0 +1,45 @@
+#ifndef __WMMENGINE_H__
+#define __WMMENGINE_H__
+
+#include <Eigen/Eigen>
+
+#define WMM_MAX_DEGREE 12
+#define WMM_COEFFICIENTS_FILE "WMM.COF"
+
+/**
+ * World Magnetic Model evaluator.
+ *
+ * The coefficient file is parsed (and Schmidt-normalised) once, on construction.
+ * field() keeps all of its scratch state on the stack, so a single engine can be
+ * queried concurrently by any number of vehicles.
+ */
+class WMMEngine {
+private:
+    double epoch;
+    // Unnormalised Gauss coefficients (g in [m][n], h in [n][m-1]) and their secular variation
+    double c[WMM_MAX_DEGREE + 1][WMM_MAX_DEGREE + 1] = {{0}};
+    double cd[WMM_MAX_DEGREE + 1][WMM_MAX_DEGREE + 1] = {{0}};
+    // Legendre recursion constants
+    double k[WMM_MAX_DEGREE + 1][WMM_MAX_DEGREE + 1] = {{0}};
+    double fn[WMM_MAX_DEGREE + 1] = {0};
+    double fm[WMM_MAX_DEGREE + 1] = {0};
+
+    void _load_coefficients(const char* path);
+    void _normalize_coefficients();
+public:
+    WMMEngine(const char* coefficients_path = WMM_COEFFICIENTS_FILE);
+    WMMEngine(WMMEngine& e) = delete;
+
+    // Engine loaded from WMM_COEFFICIENTS_FILE, shared by every caller
+    static const WMMEngine& shared_instance();
+
+    double get_epoch() const { return this->epoch; }
+
+    /**
+     * Magnetic field (north, east, down) in nT.
+     * lat/lon in degrees, altitude in km above the WGS84 ellipsoid, time in decimal years.
+     */
+    Eigen::Vector3d field(double lat_deg, double lon_deg, double alt_km, double decimal_year) const;
+};
+
+#endif // __WMMENGINE_H__
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include "MetricsRegistry.h"
+
+static std::string label_set(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) return "";
+    if (labels.empty()) return "{" + extra + "}";
+    if (extra.empty()) return "{" + labels + "}";
+    return "{" + labels + "," + extra + "}";
+}
+
+static void render_sample(std::string& out, const std::string& name, const std::string& labels, double value) {
+    char number[32];
+    snprintf(number, sizeof(number), "%.9g", value);
+    out += name + labels + " " + number + "\n";
+}
+
+#pragma mark Metrics
+
+uint64_t Counter::get() const {
+    uint64_t total = 0;
+    for (const auto& shard : this->shards) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Counter::render(std::string& out, const std::string& name, const std::string& labels) const {
+    render_sample(out, name, label_set(labels), this->get() * this->unit);
+}
+
+void Gauge::render(std::string& out, const std::string& name, const std::string& labels) const {
+    render_sample(out, name, label_set(labels), this->get());
+}
+
+void Histogram::render(std::string& out, const std::string& name, const std::string& labels) const {
+    static const double steps[] = {1, 2.5, 5};
+    for (uint64_t decade = 1000; decade <= 10000000000ULL; decade *= 10) {
+        for (double step : steps) {
+            uint64_t bound_ns = (uint64_t)(decade * step);
+            if (bound_ns > 10000000000ULL) break;
+            char le[48];
+            snprintf(le, sizeof(le), "le=\"%.9g\"", bound_ns / 1e9);
+            render_sample(out, name + "_bucket", label_set(labels, le), this->histogram.count_at_most(bound_ns));
+        }
+    }
+    render_sample(out, name + "_bucket", label_set(labels, "le=\"+Inf\""), this->histogram.get_count());
+    render_sample(out, name + "_sum", label_set(labels), this->histogram.get_total_ns() / 1e9);
+    render_sample(out, name + "_count", label_set(labels), this->histogram.get_count());
+}
+
+MsgidCounters::MsgidCounters() {
+    for (auto& counter : this->counters) counter.store(NULL, std::memory_order_relaxed);
+}
+
+Counter& MsgidCounters::_create(size_t slot) {
+    std::lock_guard<std::mutex> lock(this->create_mutex);
+    if (!this->owned[slot]) {
+        this->owned[slot].reset(new Counter());
+        this->counters[slot].store(this->owned[slot].get(), std::memory_order_release);
+    }
+    return *this->owned[slot];
+}
+
+void MsgidCounters::render(std::string& out, const std::string& name, const std::string& labels) const {
+    for (size_t slot = 0; slot <= METRICS_MSGID_SERIES; slot++) {
+        Counter* counter = this->counters[slot].load(std::memory_order_acquire);
+        if (counter == NULL) continue;
+        std::string msgid = slot < METRICS_MSGID_SERIES ? "msgid=\"" + std::to_string(slot) + "\"" : "msgid=\"other\"";
+        render_sample(out, name, label_set(labels, msgid), counter->get());
+    }
+}
+
+#pragma mark MetricsRegistry
+
+MetricsRegistry& MetricsRegistry::shared_instance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+template<class T>
+T& MetricsRegistry::_register(const std::string& name, const std::string& help, const std::string& labels, T* metric) {
+    std::unique_ptr<T> created(metric);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto& entry : this->entries) {
+        if (entry.name != name || entry.labels != labels) continue;
+        T* existing = dynamic_cast<T*>(entry.metric.get());
+        if (existing != NULL) return *existing;
+        fprintf(stderr, "Metric %s registered twice with different types\n", name.c_str());
+        break;
+    }
+    T& registered = *created;
+    this->entries.push_back(Entry{name, help, labels, std::move(created)});
+    return registered;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels, double unit) {
+    return this->_register(name, help, labels, new Counter(unit));
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    return this->_register(name, help, labels, new Gauge());
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+    return this->_register(name, help, labels, new Histogram());
+}
+
+MsgidCounters& MetricsRegistry::msgid_counters(const std::string& name, const std::string& help, const std::string& labels) {
+    return this->_register(name, help, labels, new MsgidCounters());
+}
+
+std::string MetricsRegistry::render() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::string out;
+    std::vector<bool> rendered(this->entries.size(), false);
+    // Series of one name are grouped under a single HELP / TYPE header
+    for (size_t i = 0; i < this->entries.size(); i++) {
+        if (rendered[i]) continue;
+        const Entry& first = this->entries[i];
+        out += "# HELP " + first.name + " " + first.help + "\n";
+        out += "# TYPE " + first.name + " " + first.metric->type() + "\n";
+        for (size_t j = i; j < this->entries.size(); j++) {
+            if (rendered[j] || this->entries[j].name != first.name) continue;
+            this->entries[j].metric->render(out, first.name, this->entries[j].labels);
+            rendered[j] = true;
+        }
+    }
+    return out;
+}
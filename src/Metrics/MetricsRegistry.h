@@ -0,0 +1,156 @@
+#ifndef __METRICSREGISTRY_H__
+#define __METRICSREGISTRY_H__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "../DataStructures/SPSCQueue.h"
+#include "../Profiling/LatencyHistogram.h"
+
+// Counter cells, threads are spread over them round robin
+#define METRICS_COUNTER_SHARDS 8
+// Message ids with their own series, higher ones are counted as "other"
+#define METRICS_MSGID_SERIES 256
+
+/**
+ * Sample in the Prometheus text exposition format.
+ */
+class Metric {
+public:
+    virtual ~Metric() {}
+    virtual const char* type() const = 0;
+    // Appends the samples of the metric, labels formatted as `a="x",b="y"` (may be empty)
+    virtual void render(std::string& out, const std::string& name, const std::string& labels) const = 0;
+};
+
+/**
+ * Monotonic counter. Every thread increments its own cache line,
+ * the shards are only summed when the value is read.
+ */
+class Counter : public Metric {
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    Shard shards[METRICS_COUNTER_SHARDS];
+    // Exposed value per count (e.g. 1e-9 for a count of ns exposed in s)
+    double unit;
+
+    static size_t thread_shard() {
+        static std::atomic<size_t> threads_n{0};
+        thread_local size_t shard = threads_n.fetch_add(1, std::memory_order_relaxed) % METRICS_COUNTER_SHARDS;
+        return shard;
+    }
+
+public:
+    explicit Counter(double unit = 1) : unit(unit) {}
+
+    void increment(uint64_t n = 1) {
+        this->shards[thread_shard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t get() const;
+
+    const char* type() const override { return "counter"; }
+    void render(std::string& out, const std::string& name, const std::string& labels) const override;
+};
+
+/**
+ * Last value set, by any thread.
+ */
+class Gauge : public Metric {
+private:
+    std::atomic<double> value{0};
+public:
+    void set(double value) { this->value.store(value, std::memory_order_relaxed); }
+    double get() const { return this->value.load(std::memory_order_relaxed); }
+
+    const char* type() const override { return "gauge"; }
+    void render(std::string& out, const std::string& name, const std::string& labels) const override;
+};
+
+/**
+ * Distribution of durations recorded in ns, exposed in seconds with
+ * 1-2.5-5 buckets from 1 us to 10 s.
+ */
+class Histogram : public Metric {
+private:
+    LatencyHistogram histogram;
+public:
+    void record(uint64_t ns) { this->histogram.record(ns); }
+    const LatencyHistogram& get() const { return this->histogram; }
+
+    const char* type() const override { return "histogram"; }
+    void render(std::string& out, const std::string& name, const std::string& labels) const override;
+};
+
+/**
+ * Counters labelled by MAVLink message id. The counter of an id is
+ * created (under a mutex) the first time it is seen.
+ */
+class MsgidCounters : public Metric {
+private:
+    std::atomic<Counter*> counters[METRICS_MSGID_SERIES + 1];
+    std::unique_ptr<Counter> owned[METRICS_MSGID_SERIES + 1];
+    std::mutex create_mutex;
+
+    Counter& _create(size_t slot);
+public:
+    MsgidCounters();
+
+    void increment(uint32_t msgid) {
+        size_t slot = msgid < METRICS_MSGID_SERIES ? msgid : METRICS_MSGID_SERIES;
+        Counter* counter = this->counters[slot].load(std::memory_order_acquire);
+        if (counter == NULL) counter = &this->_create(slot);
+        counter->increment();
+    }
+
+    const char* type() const override { return "counter"; }
+    void render(std::string& out, const std::string& name, const std::string& labels) const override;
+};
+
+/**
+ * Counters, gauges and histograms shared by the whole process, rendered in
+ * the Prometheus text format (served by MetricsServer).
+ *
+ * Registration takes a mutex and returns a reference that stays valid for the
+ * life of the process: callers keep it and only pay for the update on the hot
+ * path. Registering the same name and labels twice returns the same metric.
+ */
+class MetricsRegistry {
+private:
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        std::unique_ptr<Metric> metric;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    // Set while the metrics are served: enables the metrics that need clock reads
+    std::atomic<bool> enabled{false};
+
+    MetricsRegistry() {};
+
+    template<class T>
+    T& _register(const std::string& name, const std::string& help, const std::string& labels, T* metric);
+public:
+    static MetricsRegistry& shared_instance();
+    MetricsRegistry(MetricsRegistry& r) = delete;
+
+    void set_enabled(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+    bool is_enabled() const { return this->enabled.load(std::memory_order_relaxed); }
+
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "", double unit = 1);
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+    MsgidCounters& msgid_counters(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    // Every metric, in registration order
+    std::string render() const;
+};
+
+#endif // __METRICSREGISTRY_H__
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <boost/bind.hpp>
+#include "MetricsServer.h"
+
+using namespace boost::asio;
+
+// #define METRICS_SERVER_VERBOSE
+
+/**
+ * One request: reads the header, writes the exposition and closes.
+ */
+template<class Socket>
+class MetricsSession : public std::enable_shared_from_this<MetricsSession<Socket>> {
+private:
+    Socket socket;
+    boost::asio::streambuf request;
+    std::string response;
+public:
+    MetricsSession(io_service& service) : socket(service) {}
+    Socket& get_socket() { return this->socket; }
+
+    void start() {
+        auto self = this->shared_from_this();
+        async_read_until(this->socket, this->request, "\r\n\r\n",
+            [self](const boost::system::error_code& err, size_t) {
+                if (err) return;
+                self->respond();
+            });
+    }
+
+    void respond() {
+        std::string body = MetricsRegistry::shared_instance().render();
+        this->response =
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+        auto self = this->shared_from_this();
+        async_write(this->socket, buffer(this->response),
+            [self](const boost::system::error_code&, size_t) {
+                boost::system::error_code ignored;
+                self->socket.shutdown(Socket::shutdown_both, ignored);
+            });
+    }
+};
+
+MetricsServer::MetricsServer(const std::string& endpoint) : endpoint(endpoint) {}
+
+MetricsServer::~MetricsServer() {
+    this->stop();
+}
+
+template<class Acceptor>
+void MetricsServer::_accept(Acceptor& acceptor) {
+    typedef MetricsSession<typename Acceptor::protocol_type::socket> Session;
+    std::shared_ptr<Session> session = std::make_shared<Session>(this->service);
+    acceptor.async_accept(session->get_socket(), [this, &acceptor, session](const boost::system::error_code& err) {
+        if (err == error::operation_aborted) return;
+        if (!err) session->start();
+#ifdef METRICS_SERVER_VERBOSE
+        else fprintf(stderr, "Metrics endpoint accept failed: %s\n", err.message().c_str());
+#endif
+        this->_accept(acceptor);
+    });
+}
+
+bool MetricsServer::start() {
+    try {
+        if (this->endpoint.compare(0, 5, "unix:") == 0) {
+            this->socket_path = this->endpoint.substr(5);
+            // Left behind by a previous run
+            unlink(this->socket_path.c_str());
+            this->unix_acceptor.reset(new local::stream_protocol::acceptor(
+                this->service, local::stream_protocol::endpoint(this->socket_path)));
+            this->_accept(*this->unix_acceptor);
+        } else {
+            int port = std::stoi(this->endpoint);
+            this->tcp_acceptor.reset(new ip::tcp::acceptor(
+                this->service, ip::tcp::endpoint(ip::address_v4::loopback(), port)));
+            this->_accept(*this->tcp_acceptor);
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "Cannot serve metrics on %s: %s\n", this->endpoint.c_str(), e.what());
+        return false;
+    }
+
+    MetricsRegistry::shared_instance().set_enabled(true);
+    this->thread = boost::thread([this]() { this->service.run(); });
+    printf("Serving metrics on %s\n", this->endpoint.c_str());
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!this->thread.joinable()) return;
+    this->service.stop();
+    this->thread.join();
+    MetricsRegistry::shared_instance().set_enabled(false);
+    if (!this->socket_path.empty()) unlink(this->socket_path.c_str());
+}
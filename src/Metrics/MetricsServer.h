@@ -0,0 +1,41 @@
+#ifndef __METRICSSERVER_H__
+#define __METRICSSERVER_H__
+
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+#include <memory>
+#include <string>
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+#include "MetricsRegistry.h"
+
+/**
+ * Serves the shared MetricsRegistry in the Prometheus text format over HTTP,
+ * from its own thread, on either:
+ * - "<port>": TCP on 127.0.0.1 (curl http://127.0.0.1:<port>/metrics)
+ * - "unix:<path>": a Unix domain socket (curl --unix-socket <path> http://localhost/metrics)
+ *
+ * Every request gets the full exposition, whatever its path.
+ */
+class MetricsServer {
+private:
+    std::string endpoint;
+    std::string socket_path;
+    boost::asio::io_service service;
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> tcp_acceptor;
+    std::unique_ptr<boost::asio::local::stream_protocol::acceptor> unix_acceptor;
+    boost::thread thread;
+
+    template<class Acceptor>
+    void _accept(Acceptor& acceptor);
+public:
+    explicit MetricsServer(const std::string& endpoint);
+    ~MetricsServer();
+    MetricsServer(MetricsServer& s) = delete;
+
+    // Binds the endpoint and starts serving, false (and logged) when the endpoint is unusable
+    bool start();
+    void stop();
+};
+
+#endif // __METRICSSERVER_H__
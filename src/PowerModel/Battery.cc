@@ -0,0 +1,49 @@
+#include <cmath>
+#include <algorithm>
+#include "Battery.h"
+
+// LiPo cell open circuit voltage from 0% to 100% charge, 10% steps
+static const double LIPO_CELL_OCV[] = {3.27, 3.61, 3.69, 3.71, 3.73, 3.75, 3.79, 3.84, 3.91, 4.01, 4.20};
+#define LIPO_CELL_OCV_POINTS 11
+
+Battery::Battery(const BatteryConfig& config) : config(config) {
+    this->capacity_coulomb = config.capacity_mah * 3.6;
+    this->full_voltage = this->open_circuit_voltage(1);
+    this->state = BatteryState{this->full_voltage, 0, 0, 0, 1, config.temperature};
+}
+
+double Battery::open_circuit_voltage(double remaining) const {
+    double f = std::max(0.0, std::min(remaining, 1.0)) * (LIPO_CELL_OCV_POINTS - 1);
+    int i = std::min((int)f, LIPO_CELL_OCV_POINTS - 2);
+    double cell = LIPO_CELL_OCV[i] + (f - i) * (LIPO_CELL_OCV[i + 1] - LIPO_CELL_OCV[i]);
+    return cell * this->config.cells;
+}
+
+void Battery::step(double dt, double power) {
+    if (dt <= 0) return;
+
+    // P = V I with V = OCV - V1 - R0 I: the smaller root of R0 I^2 - (OCV - V1) I + P = 0
+    double source = this->open_circuit_voltage(this->state.remaining) - this->polarization;
+    double r0 = this->config.internal_resistance;
+    double current = this->config.avionics_current;
+    if (power > 0 && r0 <= 0) {
+        // No series resistance: the load sees the source voltage
+        current += source > 0 ? power / source : 0;
+    } else if (power > 0) {
+        double discriminant = source * source - 4 * r0 * power;
+        // Beyond the maximum power the pack can deliver, the current is clamped to its peak
+        current += discriminant > 0 ? (source - std::sqrt(discriminant)) / (2 * r0) : source / (2 * r0);
+    }
+
+    // Exact update of the R1 || C1 branch under constant current
+    double r1 = this->config.polarization_resistance;
+    double tau = r1 * this->config.polarization_capacitance;
+    double decay = tau > 0 ? std::exp(-dt / tau) : 0;
+    this->polarization = current * r1 + (this->polarization - current * r1) * decay;
+
+    this->state.current = current;
+    this->state.voltage = std::max(0.0, source - r0 * current);
+    this->state.consumed_mah += current * dt / 3.6;
+    this->state.consumed_energy += this->state.voltage * current * dt;
+    this->state.remaining = std::max(0.0, this->state.remaining - current * dt / this->capacity_coulomb);
+}
@@ -0,0 +1,47 @@
+#ifndef __BATTERY_H__
+#define __BATTERY_H__
+
+#include "../Containers/BatteryConfig.h"
+
+struct BatteryState {
+    double voltage;             // terminal voltage (V)
+    double current;             // A
+    double consumed_mah;
+    double consumed_energy;     // J
+    double remaining;           // state of charge [0, 1]
+    double temperature;         // degC
+};
+
+/**
+ * LiPo pack as a Thevenin equivalent circuit: open circuit voltage of the
+ * state of charge, series resistance R0 and one R1 || C1 polarization branch.
+ *
+ * Stepped once per tick with the electrical power drawn by the vehicle;
+ * the current is solved against the terminal voltage.
+ */
+class Battery {
+private:
+    BatteryConfig config;
+    double capacity_coulomb;
+    double full_voltage;
+    // Voltage across the polarization branch (V)
+    double polarization = 0;
+    BatteryState state;
+
+    double open_circuit_voltage(double remaining) const;
+public:
+    Battery(const BatteryConfig& config);
+
+    /**
+     * @param dt        s
+     * @param power     electrical power drawn by the propulsion (W), avionics excluded
+     */
+    void step(double dt, double power);
+
+    const BatteryState& get_state() const { return this->state; }
+    const BatteryConfig& get_config() const { return this->config; }
+    // Terminal over full charge open circuit voltage, scales what the motors can deliver
+    double voltage_ratio() const { return this->state.voltage / this->full_voltage; }
+};
+
+#endif // __BATTERY_H__
@@ -0,0 +1,24 @@
+#ifndef __PROPULSIONPOWER_H__
+#define __PROPULSIONPOWER_H__
+
+#include <cmath>
+#include <algorithm>
+#include "../Containers/BatteryConfig.h"
+
+/**
+ * Electrical power drawn by one propeller (W), from actuator disk momentum
+ * theory scaled by the figure of merit and the motor / ESC efficiency.
+ * @param thrust    propeller thrust (N)
+ * @param inflow    axial air speed through the disk, positive along the thrust (m/s)
+ * @param rho       air density (kg/m**3)
+ */
+static inline double propeller_electrical_power(double thrust, double inflow, double rho, const BatteryConfig& config) {
+    if (thrust <= 0) return 0;
+    double disk_area = M_PI * 0.25 * config.propeller_diameter * config.propeller_diameter;
+    // Descending faster than the induced velocity (windmill state) is not modelled, the disk sees no inflow
+    inflow = std::max(0.0, inflow);
+    double induced = -0.5 * inflow + std::sqrt(0.25 * inflow * inflow + thrust / (2 * rho * disk_area));
+    return thrust * (inflow + induced) / (config.figure_of_merit * config.motor_efficiency);
+}
+
+#endif // __PROPULSIONPOWER_H__
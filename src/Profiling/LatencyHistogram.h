@@ -0,0 +1,104 @@
+#ifndef __LATENCYHISTOGRAM_H__
+#define __LATENCYHISTOGRAM_H__
+
+#include <atomic>
+#include <stdint.h>
+
+// 2^4 linear sub-buckets per power of two: bucket width <= 1/16 of its value
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 4
+#define LATENCY_HISTOGRAM_SUB_BUCKETS (1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+#define LATENCY_HISTOGRAM_BUCKETS ((64 - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * HDR-style log-linear histogram of durations (ns), covering the whole
+ * uint64_t range at a constant relative precision (~6%).
+ *
+ * Recording is a handful of relaxed atomic operations and never allocates,
+ * so it can be fed from any thread. Percentiles are read from a snapshot
+ * that may straddle concurrent recordings.
+ */
+class LatencyHistogram {
+private:
+    std::atomic<uint64_t> buckets[LATENCY_HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+
+    static int bucket_for(uint64_t ns) {
+        if (ns < LATENCY_HISTOGRAM_SUB_BUCKETS) return (int)ns;
+        int magnitude = 63 - __builtin_clzll(ns);
+        int shift = magnitude - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+        int sub_bucket = (int)(ns >> shift) - LATENCY_HISTOGRAM_SUB_BUCKETS;
+        return (shift + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+    }
+
+    // Largest value that falls in the bucket
+    static uint64_t bucket_upper_bound(int bucket) {
+        if (bucket < LATENCY_HISTOGRAM_SUB_BUCKETS) return bucket;
+        int shift = bucket / LATENCY_HISTOGRAM_SUB_BUCKETS - 1;
+        uint64_t sub_bucket = bucket % LATENCY_HISTOGRAM_SUB_BUCKETS + LATENCY_HISTOGRAM_SUB_BUCKETS;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+public:
+    LatencyHistogram() { this->reset(); }
+    LatencyHistogram(const LatencyHistogram&) = delete;
+
+    void record(uint64_t ns) {
+        this->buckets[bucket_for(ns)].fetch_add(1, std::memory_order_relaxed);
+        this->count.fetch_add(1, std::memory_order_relaxed);
+        this->total_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = this->max_ns.load(std::memory_order_relaxed);
+        while (ns > max && !this->max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed));
+    }
+
+    void reset() {
+        for (auto& bucket : this->buckets) bucket.store(0, std::memory_order_relaxed);
+        this->count.store(0, std::memory_order_relaxed);
+        this->total_ns.store(0, std::memory_order_relaxed);
+        this->max_ns.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t get_count() const { return this->count.load(std::memory_order_relaxed); }
+    uint64_t get_total_ns() const { return this->total_ns.load(std::memory_order_relaxed); }
+    uint64_t get_max_ns() const { return this->max_ns.load(std::memory_order_relaxed); }
+    double get_mean_ns() const {
+        uint64_t n = this->get_count();
+        return n > 0 ? (double)this->get_total_ns() / n : 0;
+    }
+
+    /**
+     * Upper bound of the bucket holding the p-th percentile (p in [0, 100]),
+     * never above the largest recorded value.
+     */
+    uint64_t percentile(double p) const {
+        uint64_t n = this->get_count();
+        if (n == 0) return 0;
+        uint64_t rank = (uint64_t)(p / 100.0 * n + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+            seen += this->buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t bound = bucket_upper_bound(i);
+                uint64_t max = this->get_max_ns();
+                return bound < max ? bound : max;
+            }
+        }
+        return this->get_max_ns();
+    }
+
+    /**
+     * Recordings in the buckets lying entirely at or below `ns`
+     * (cumulative bucket of a coarser histogram).
+     */
+    uint64_t count_at_most(uint64_t ns) const {
+        uint64_t n = 0;
+        for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS && bucket_upper_bound(i) <= ns; i++) {
+            n += this->buckets[i].load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+};
+
+#endif // __LATENCYHISTOGRAM_H__
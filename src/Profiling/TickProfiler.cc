@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include "TickProfiler.h"
+
+TickProfiler& TickProfiler::shared_instance() {
+    static TickProfiler instance;
+    return instance;
+}
+
+const char* TickProfiler::stage_name(ProfileStage stage) {
+    switch (stage) {
+        case PROFILE_TICK: return "tick";
+        case PROFILE_MESSAGE_DRAIN: return "message_drain";
+        case PROFILE_OBJECT_UPDATE: return "object_update";
+        case PROFILE_FORCE_MODELS: return "force_models";
+        case PROFILE_INTEGRATION: return "integration";
+        case PROFILE_GROUND_CONTACT: return "ground_contact";
+        case PROFILE_SENSOR_SAMPLING: return "sensor_sampling";
+        case PROFILE_ENCODING: return "encoding";
+        case PROFILE_SOCKET_SEND: return "socket_send";
+        case PROFILE_OBSERVERS: return "observers";
+        default: return "unknown";
+    }
+}
+
+ProfileStageSummary TickProfiler::summary(ProfileStage stage) const {
+    const LatencyHistogram& h = this->histograms[stage];
+    return ProfileStageSummary{
+        h.get_count(),
+        h.get_mean_ns(),
+        h.percentile(50),
+        h.percentile(90),
+        h.percentile(99),
+        h.get_max_ns(),
+        h.get_total_ns()
+    };
+}
+
+double TickProfiler::window_s() const {
+    boost::chrono::microseconds elapsed = boost::chrono::duration_cast<boost::chrono::microseconds>(
+        boost::chrono::steady_clock::now() - this->window_start);
+    return elapsed.count() / 1000000.0;
+}
+
+std::string TickProfiler::report() const {
+    double window = this->window_s();
+    char line[256];
+    snprintf(line, sizeof(line), "[TICK PROFILE] last %.1f s (us)\n%-16s %10s %9s %9s %9s %9s %9s %7s\n",
+        window, "stage", "count", "mean", "p50", "p90", "p99", "max", "%wall");
+    std::string report(line);
+    for (int i = 0; i < PROFILE_STAGES_N; i++) {
+        ProfileStageSummary s = this->summary((ProfileStage)i);
+        if (s.count == 0) continue;
+        snprintf(line, sizeof(line), "%-16s %10llu %9.2f %9.2f %9.2f %9.2f %9.2f %6.1f%%\n",
+            stage_name((ProfileStage)i), (unsigned long long)s.count,
+            s.mean_ns / 1000.0, s.p50_ns / 1000.0, s.p90_ns / 1000.0, s.p99_ns / 1000.0, s.max_ns / 1000.0,
+            window > 0 ? s.total_ns / 1e9 / window * 100 : 0.0);
+        report += line;
+    }
+    return report;
+}
+
+void TickProfiler::reset() {
+    for (auto& h : this->histograms) h.reset();
+    this->window_start = boost::chrono::steady_clock::now();
+}
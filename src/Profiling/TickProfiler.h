@@ -0,0 +1,95 @@
+#ifndef __TICKPROFILER_H__
+#define __TICKPROFILER_H__
+
+#include <atomic>
+#include <string>
+#include <boost/chrono.hpp>
+#include "LatencyHistogram.h"
+
+/**
+ * Stages of a simulation tick. Timings are inclusive: a stage
+ * nested in another (e.g. ground contact in integration) is also
+ * counted in its parent.
+ */
+enum ProfileStage {
+    PROFILE_TICK,               // Simulator::update
+    PROFILE_MESSAGE_DRAIN,      // inbound MAVLink queues
+    PROFILE_OBJECT_UPDATE,      // one environment object
+    PROFILE_FORCE_MODELS,       // wind and per tick force models
+    PROFILE_INTEGRATION,        // ODE step
+    PROFILE_GROUND_CONTACT,     // landing gear, every solver stage
+    PROFILE_SENSOR_SAMPLING,    // sensor frame
+    PROFILE_ENCODING,           // MAVLink message packing
+    PROFILE_SOCKET_SEND,        // MAVLink frame out
+    PROFILE_OBSERVERS,          // drone state processors
+    PROFILE_STAGES_N
+};
+
+struct ProfileStageSummary {
+    uint64_t count;
+    double mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+    uint64_t total_ns;
+};
+
+/**
+ * Per-stage tick latency histograms, shared by the whole process.
+ *
+ * Always compiled in, disabled by default: a disabled scope costs one
+ * relaxed load. Enabled, a scope costs two steady_clock reads and a
+ * histogram update.
+ */
+class TickProfiler {
+private:
+    std::atomic<bool> enabled{false};
+    LatencyHistogram histograms[PROFILE_STAGES_N];
+    boost::chrono::steady_clock::time_point window_start = boost::chrono::steady_clock::now();
+
+    TickProfiler() {};
+public:
+    static TickProfiler& shared_instance();
+    TickProfiler(TickProfiler& p) = delete;
+
+    static const char* stage_name(ProfileStage stage);
+
+    void set_enabled(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+    bool is_enabled() const { return this->enabled.load(std::memory_order_relaxed); }
+
+    void record(ProfileStage stage, uint64_t ns) { this->histograms[stage].record(ns); }
+    const LatencyHistogram& histogram(ProfileStage stage) const { return this->histograms[stage]; }
+    ProfileStageSummary summary(ProfileStage stage) const;
+
+    // Wall time covered by the current histograms (s)
+    double window_s() const;
+    // Table of every stage seen since the last reset
+    std::string report() const;
+    // Starts a new window
+    void reset();
+};
+
+/**
+ * Times its enclosing scope into a stage of the shared profiler.
+ */
+class ProfileScope {
+private:
+    ProfileStage stage;
+    bool active;
+    boost::chrono::steady_clock::time_point start;
+public:
+    explicit ProfileScope(ProfileStage stage) :
+        stage(stage),
+        active(TickProfiler::shared_instance().is_enabled()) {
+            if (this->active) this->start = boost::chrono::steady_clock::now();
+        }
+
+    ~ProfileScope() {
+        if (!this->active) return;
+        boost::chrono::nanoseconds elapsed = boost::chrono::steady_clock::now() - this->start;
+        TickProfiler::shared_instance().record(this->stage, elapsed.count());
+    }
+};
+
+#endif // __TICKPROFILER_H__
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include "TraceRecorder.h"
+
+static thread_local TraceBuffer* thread_buffer = NULL;
+
+TraceRecorder& TraceRecorder::shared_instance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+void TraceRecorder::start(const std::string& path, size_t events_per_thread) {
+    this->output_path = path;
+    this->events_per_thread = events_per_thread > 0 ? events_per_thread : 1;
+    this->origin = boost::chrono::steady_clock::now();
+    this->enabled.store(true, std::memory_order_release);
+}
+
+TraceBuffer& TraceRecorder::buffer_for_this_thread() {
+    if (thread_buffer == NULL) {
+        std::lock_guard<std::mutex> lock(this->buffers_mutex);
+        this->buffers.emplace_back(new TraceBuffer(this->events_per_thread, this->buffers.size() + 1));
+        thread_buffer = this->buffers.back().get();
+        thread_buffer->thread_name = "thread " + std::to_string(thread_buffer->tid);
+    }
+    return *thread_buffer;
+}
+
+void TraceRecorder::record(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t msgid) {
+    if (!this->is_enabled()) return;
+    this->buffer_for_this_thread().append(TraceEvent{name, begin_ns, end_ns > begin_ns ? end_ns - begin_ns : 0, msgid});
+}
+
+void TraceRecorder::set_thread_name(const char* name) {
+    if (!this->is_enabled()) return;
+    this->buffer_for_this_thread().thread_name = name;
+}
+
+bool TraceRecorder::write() {
+    if (!this->enabled.exchange(false)) return true;
+
+    FILE* f = fopen(this->output_path.c_str(), "w");
+    if (f == NULL) {
+        fprintf(stderr, "Could not write trace to %s\n", this->output_path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->buffers_mutex);
+    uint64_t dropped = 0;
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"6dof\"}}");
+    for (const auto& buffer : this->buffers) {
+        fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            buffer->tid, buffer->thread_name.c_str());
+
+        uint64_t appended = buffer->appended.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->events.size();
+        // Once wrapped, the oldest slot may be mid-overwrite by a late event: skip it
+        uint64_t first = appended > capacity ? appended - capacity + 1 : 0;
+        dropped += first;
+        for (uint64_t i = first; i < appended; i++) {
+            const TraceEvent& e = buffer->events[i % capacity];
+            fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                e.name, buffer->tid, e.begin_ns / 1000.0, e.duration_ns / 1000.0);
+            if (e.msgid != TRACE_NO_MSGID) fprintf(f, ",\"args\":{\"msgid\":%lld}", (long long)e.msgid);
+            fprintf(f, "}");
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+
+    printf("Trace written to %s", this->output_path.c_str());
+    if (dropped > 0) printf(" (%llu oldest events overwritten)", (unsigned long long)dropped);
+    printf("\n");
+    return true;
+}
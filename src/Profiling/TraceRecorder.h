@@ -0,0 +1,106 @@
+#ifndef __TRACERECORDER_H__
+#define __TRACERECORDER_H__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/chrono.hpp>
+
+// Ring of the most recent events kept per thread (32 bytes each)
+#define TRACE_DEFAULT_EVENTS_PER_THREAD (1 << 18)
+#define TRACE_NO_MSGID -1
+
+struct TraceEvent {
+    const char* name;       // static string
+    uint64_t begin_ns;      // since the recorder started
+    uint64_t duration_ns;
+    int64_t msgid;          // MAVLink message id, TRACE_NO_MSGID for other events
+};
+
+/**
+ * Events of a single thread. Only the owning thread appends,
+ * the writer reads it back once recording has stopped.
+ */
+struct TraceBuffer {
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> appended{0};
+    uint32_t tid;
+    std::string thread_name;
+
+    TraceBuffer(size_t capacity, uint32_t tid) : events(capacity), tid(tid) {}
+
+    void append(const TraceEvent& event) {
+        uint64_t n = this->appended.load(std::memory_order_relaxed);
+        this->events[n % this->events.size()] = event;
+        this->appended.store(n + 1, std::memory_order_release);
+    }
+};
+
+/**
+ * Timeline of simulation ticks, MAVLink traffic and observer calls,
+ * written as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Every thread records into its own buffer without locking; a buffer is
+ * registered (under a mutex) the first time its thread records. Buffers are
+ * rings: a long run keeps its last TRACE_DEFAULT_EVENTS_PER_THREAD events.
+ */
+class TraceRecorder {
+private:
+    std::atomic<bool> enabled{false};
+    std::string output_path;
+    size_t events_per_thread = TRACE_DEFAULT_EVENTS_PER_THREAD;
+    boost::chrono::steady_clock::time_point origin = boost::chrono::steady_clock::now();
+
+    std::mutex buffers_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+    TraceRecorder() {};
+    TraceBuffer& buffer_for_this_thread();
+public:
+    static TraceRecorder& shared_instance();
+    TraceRecorder(TraceRecorder& r) = delete;
+
+    // Starts recording, the trace is written to `path` by write()
+    void start(const std::string& path, size_t events_per_thread = TRACE_DEFAULT_EVENTS_PER_THREAD);
+    bool is_enabled() const { return this->enabled.load(std::memory_order_relaxed); }
+
+    uint64_t now_ns() const {
+        return boost::chrono::duration_cast<boost::chrono::nanoseconds>(boost::chrono::steady_clock::now() - this->origin).count();
+    }
+
+    void record(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t msgid = TRACE_NO_MSGID);
+    // Label of the calling thread in the timeline
+    void set_thread_name(const char* name);
+
+    // Stops recording and writes the trace, false if it could not be written
+    bool write();
+};
+
+/**
+ * Records its enclosing scope as a trace event.
+ */
+class TraceScope {
+private:
+    const char* name;
+    int64_t msgid;
+    bool active;
+    uint64_t begin_ns = 0;
+public:
+    explicit TraceScope(const char* name, int64_t msgid = TRACE_NO_MSGID) :
+        name(name),
+        msgid(msgid),
+        active(TraceRecorder::shared_instance().is_enabled()) {
+            if (this->active) this->begin_ns = TraceRecorder::shared_instance().now_ns();
+        }
+
+    ~TraceScope() {
+        if (!this->active) return;
+        TraceRecorder& recorder = TraceRecorder::shared_instance();
+        recorder.record(this->name, this->begin_ns, recorder.now_ns(), this->msgid);
+    }
+};
+
+#endif // __TRACERECORDER_H__
@@ -0,0 +1,20 @@
+#include <algorithm>
+#include "RotorDynamics.h"
+
+RotorDynamics::RotorDynamics(int rotors, double time_constant) :
+    inv_time_constant(Eigen::ArrayXd::Constant(rotors, 1.0 / std::max(time_constant, ROTOR_MIN_TIME_CONSTANT))),
+    command(Eigen::ArrayXd::Zero(rotors))
+    {}
+
+void RotorDynamics::set_command(const Eigen::VectorXd& speeds) {
+    // ESCs cannot reverse the motors
+    this->command = speeds.array().max(0.0);
+}
+
+void RotorDynamics::derivative(const Eigen::Ref<const Eigen::VectorXd>& speeds, Eigen::Ref<Eigen::VectorXd> rates) const {
+    rates = ((this->command - speeds.array()) * this->inv_time_constant).matrix();
+}
+
+void RotorDynamics::propagate(const Eigen::Ref<const Eigen::VectorXd>& speeds, double dt, Eigen::Ref<Eigen::VectorXd> out) const {
+    out = (this->command + (speeds.array() - this->command) * (-dt * this->inv_time_constant).exp()).matrix();
+}
@@ -0,0 +1,41 @@
+#ifndef __ROTORDYNAMICS_H__
+#define __ROTORDYNAMICS_H__
+
+#include <Eigen/Eigen>
+
+// Below this the motor lag is treated as this short (s)
+#define ROTOR_MIN_TIME_CONSTANT 1e-4
+
+enum RotorIntegration {
+    // Rotor speeds are integrated by the ODE solver with the rest of the state
+    EXPLICIT_ROTORS,
+    // Exact solution of the lag under the command held over the step,
+    // stable for any time constant / step ratio
+    EXPONENTIAL_ROTORS
+};
+
+/**
+ * Motor + ESC model of n rotors: each rotor speed follows its (non negative)
+ * commanded speed with a first order lag, d omega/dt = (command - omega) / tau.
+ * The command is held constant over an integration step.
+ */
+class RotorDynamics {
+private:
+    Eigen::ArrayXd inv_time_constant;
+    Eigen::ArrayXd command;
+public:
+    RotorDynamics(int rotors, double time_constant);
+
+    int size() const { return this->command.size(); }
+
+    // Commanded rotor speeds (rad/s)
+    void set_command(const Eigen::VectorXd& speeds);
+    const Eigen::ArrayXd& get_command() const { return this->command; }
+
+    // d omega / dt at `speeds`
+    void derivative(const Eigen::Ref<const Eigen::VectorXd>& speeds, Eigen::Ref<Eigen::VectorXd> rates) const;
+    // Rotor speeds `dt` seconds after `speeds`
+    void propagate(const Eigen::Ref<const Eigen::VectorXd>& speeds, double dt, Eigen::Ref<Eigen::VectorXd> out) const;
+};
+
+#endif // __ROTORDYNAMICS_H__
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/thread/thread.hpp>
 #include "Simulator.h"
@@ -6,6 +7,12 @@
 
 Simulator::Simulator(SimulatorConfig c) : 
     config(c),
+    ticks_metric(MetricsRegistry::shared_instance().counter("sim6dof_ticks_total", "Simulation ticks, lockstep waits included")),
+    sim_time_metric(MetricsRegistry::shared_instance().gauge("sim6dof_sim_time_seconds", "Simulation clock")),
+    speed_ratio_metric(MetricsRegistry::shared_instance().gauge("sim6dof_speed_ratio", "Simulation time over wall time, last second")),
+    lockstep_wait_metric(MetricsRegistry::shared_instance().histogram("sim6dof_lockstep_wait_seconds", "Wall time the simulation clock stayed locked, waiting for the autopilot")),
+    queue_depth_metric(MetricsRegistry::shared_instance().gauge("sim6dof_queue_depth", "Inbound MAVLink frames found by the last drain", "queue=\"simulator\"")),
+    queue_dropped_metric(MetricsRegistry::shared_instance().counter("sim6dof_queue_dropped_frames_total", "Inbound MAVLink frames dropped on a full queue", "queue=\"simulator\"")),
     logger(ConsoleLogger::shared_instance())
 {
     // this->message_relay.add_message_handler(this);
@@ -30,48 +37,108 @@ void Simulator::update(boost::chrono::microseconds us) {
         return;
     }
 
+    ProfileScope tick_scope(PROFILE_TICK);
+    TraceRecorder& trace = TraceRecorder::shared_instance();
+    bool observed = trace.is_enabled() || MetricsRegistry::shared_instance().is_enabled();
+    uint64_t tick_begin_ns = observed ? trace.now_ns() : 0;
+    this->ticks_metric.increment();
+    boost::chrono::microseconds time_before = this->simulation_clock.get_current_time_us();
+
     this->simulation_clock.step();
     this->_process_mavlink_messages();
     for (auto e : this->env_objects) {
+        ProfileScope object_scope(PROFILE_OBJECT_UPDATE);
         e->update(us);
     }
+
+    if (observed) this->_observe_tick(tick_begin_ns, time_before != this->simulation_clock.get_current_time_us());
 }
 
-void Simulator::handle_mavlink_message(mavlink_message_t m) {
-    this->message_queue.push(m);
+/**
+ * Ticks that find the clock locked are not observed one by one:
+ * they are merged into a single lockstep wait (trace event and histogram sample).
+ */
+void Simulator::_observe_tick(uint64_t tick_begin_ns, bool time_advanced) {
+    TraceRecorder& trace = TraceRecorder::shared_instance();
+    MetricsRegistry& metrics = MetricsRegistry::shared_instance();
+    if (!time_advanced) {
+        if (this->lockstep_wait_begin_ns == 0) this->lockstep_wait_begin_ns = std::max<uint64_t>(tick_begin_ns, 1);
+        return;
+    }
+    if (this->lockstep_wait_begin_ns != 0) {
+        if (trace.is_enabled()) trace.record("lockstep wait", this->lockstep_wait_begin_ns, tick_begin_ns);
+        if (metrics.is_enabled()) this->lockstep_wait_metric.record(tick_begin_ns - this->lockstep_wait_begin_ns);
+        this->lockstep_wait_begin_ns = 0;
+    }
+    if (trace.is_enabled()) trace.record("Simulator::update", tick_begin_ns, trace.now_ns());
+
+    if (metrics.is_enabled()) {
+        boost::chrono::microseconds time = this->simulation_clock.get_current_time_us();
+        this->sim_time_metric.set(time.count() / 1000000.0);
+        if (tick_begin_ns - this->speed_sample_ns >= 1000000000ULL) {
+            if (this->speed_sample_ns != 0) {
+                this->speed_ratio_metric.set((time - this->speed_sample_time).count() * 1000.0 / (tick_begin_ns - this->speed_sample_ns));
+            }
+            this->speed_sample_ns = tick_begin_ns;
+            this->speed_sample_time = time;
+        }
+    }
+}
+
+void Simulator::handle_mavlink_message(const mavlink_message_t& m) {
+    if (!this->message_queue.push(m)) this->queue_dropped_metric.increment();
 }
 
 void Simulator::start() {
     this->logger->log(SIMULATION_STARTED);
     boost::chrono::microseconds time_increment = this->get_config().timestep_us;
+    TraceRecorder::shared_instance().set_thread_name("simulation");
     while(!this->should_shutdown) {
         if (this->config.running_lockstep) {
-            boost::chrono::high_resolution_clock::time_point before;
-            boost::chrono::high_resolution_clock::time_point after;
-            before = boost::chrono::high_resolution_clock::now();
             this->update(time_increment);
-            after = boost::chrono::high_resolution_clock::now();
-            boost::chrono::microseconds computation_time = boost::chrono::duration_cast<boost::chrono::microseconds>(time_increment - (after-before));
-            // boost::this_thread::sleep_for((time_increment - computation_time).count() > 0 ? time_increment - computation_time : boost::chrono::microseconds{0});
         } else {
             this->update(time_increment);
             boost::this_thread::sleep_for(boost::chrono::milliseconds(4));
         }
+
+        if (this->profile_report_period.count() > 0 &&
+            boost::chrono::steady_clock::now() - this->last_profile_report >= this->profile_report_period) {
+            this->_report_profile();
+        }
     }
 
+    if (TickProfiler::shared_instance().is_enabled()) this->_report_profile();
+
     for (auto p : this->drone_state_processors) {
         p->simulation_complete();
     }
 }
 
-void Simulator::_process_mavlink_message(mavlink_message_t m) {
+void Simulator::_process_mavlink_message(const mavlink_message_t& m) {
     this->should_advance_time = true;
 }
 
 void Simulator::_process_mavlink_messages() {
-    this->message_queue.consume_all([this](mavlink_message_t m){
+    ProfileScope scope(PROFILE_MESSAGE_DRAIN);
+    size_t drained = this->message_queue.consume_all([this](const mavlink_message_t& m){
         this->_process_mavlink_message(m);
     });
+    this->queue_depth_metric.set(drained);
+}
+
+void Simulator::enable_profiling(boost::chrono::microseconds report_period) {
+    this->profile_report_period = report_period;
+    this->last_profile_report = boost::chrono::steady_clock::now();
+    TickProfiler::shared_instance().reset();
+    TickProfiler::shared_instance().set_enabled(true);
+}
+
+void Simulator::_report_profile() {
+    TickProfiler& profiler = TickProfiler::shared_instance();
+    this->logger->log(profiler.report());
+    fflush(stdout);
+    profiler.reset();
+    this->last_profile_report = boost::chrono::steady_clock::now();
 }
 
 void Simulator::pause() {
@@ -2,18 +2,23 @@
 #define __SIMULATOR_H__
 
 #include <boost/chrono.hpp>
+#include <atomic>
 #include <memory>
-#include <boost/lockfree/queue.hpp>
+#include "DataStructures/SPSCQueue.h"
 #include "Interfaces/PrettyPrintable.h"
 #include "Interfaces/Environment.h"
 #include "Interfaces/MAVLinkMessageRelay.h"
 #include "Interfaces/MAVLinkMessageHandler.h"
 #include "Interfaces/Clock.h"
 #include "Interfaces/DroneStateProcessor.h"
+#include "Profiling/TickProfiler.h"
+#include "Profiling/TraceRecorder.h"
+#include "Metrics/MetricsRegistry.h"
 
 #define SIMULATION_STARTED "Simulation started."
 #define SIMULATION_PAUSED "Simulation paused."
 #define SIMULATION_RESUMED "Simulation resumed."
+#define SIMULATOR_INBOUND_QUEUE_CAPACITY 256
 
 struct SimulatorConfig {
     boost::chrono::microseconds timestep_us;
@@ -38,12 +43,32 @@ private:
     boost::chrono::microseconds stop_after_us{0};
 
     SimulatorConfig config;
-    boost::lockfree::queue<mavlink_message_t, boost::lockfree::capacity<50>> message_queue;
+    SPSCQueue<mavlink_message_t> message_queue{SIMULATOR_INBOUND_QUEUE_CAPACITY};
 
     bool should_advance_time = false;
-    bool should_shutdown = false;
-
-    void _process_mavlink_message(mavlink_message_t m);
+    std::atomic<bool> should_shutdown{false};
+
+    // Start of the current lockstep wait (TraceRecorder ns), 0 when not waiting
+    uint64_t lockstep_wait_begin_ns = 0;
+    void _observe_tick(uint64_t tick_begin_ns, bool time_advanced);
+
+    // Registered in MetricsRegistry::shared_instance()
+    Counter& ticks_metric;
+    Gauge& sim_time_metric;
+    Gauge& speed_ratio_metric;
+    Histogram& lockstep_wait_metric;
+    Gauge& queue_depth_metric;
+    Counter& queue_dropped_metric;
+    // Last simulation / wall time pair of the speed ratio
+    uint64_t speed_sample_ns = 0;
+    boost::chrono::microseconds speed_sample_time{0};
+
+    // Wall time between tick profile reports, 0: report at the end only
+    boost::chrono::microseconds profile_report_period{0};
+    boost::chrono::steady_clock::time_point last_profile_report;
+    void _report_profile();
+
+    void _process_mavlink_message(const mavlink_message_t& m);
     void _process_mavlink_messages();
 
     std::vector<DroneStateProcessor*> drone_state_processors;
@@ -58,7 +83,7 @@ public:
     SimulatorConfig get_config();
 
     std::string str() override;
-    void handle_mavlink_message(mavlink_message_t m) override;
+    void handle_mavlink_message(const mavlink_message_t& m) override;
 
     void add_environment_object(EnvironmentObject& e) override;
     void add_drone_state_processor(DroneStateProcessor* processor) {
@@ -67,9 +92,17 @@ public:
 
     void update(boost::chrono::microseconds ms) override;
     void start() override;
+    // Ends start() after the current tick, safe to call from a signal handler
+    void stop() { this->should_shutdown = true; }
     void pause() override;
     void resume() override;
 
+    /**
+     * Enables the tick profiler (see Profiling/TickProfiler.h), logging its
+     * summary every `report_period` of wall time and when the simulation ends.
+     */
+    void enable_profiling(boost::chrono::microseconds report_period);
+
     void start(boost::chrono::microseconds stop_after) {
         this->stop_after_us = stop_after;
         this->start();
@@ -77,6 +110,7 @@ public:
 
     void new_drone_state(Eigen::VectorXd state, Eigen::VectorXd dx_state) override {
         for (auto p : this->drone_state_processors) {
+            TraceScope scope("DroneStateProcessor::new_drone_state");
             p->new_drone_state(state, dx_state);
         }
     }
@@ -1,28 +1,27 @@
 #include "MAVLinkConnectionHandler.h"
 #include "../Logging/ConsoleLogger.h"
+#include "../Profiling/TickProfiler.h"
+#include "../Profiling/TraceRecorder.h"
 
 static ConsoleLogger* c = ConsoleLogger::shared_instance();
 
 MAVLinkConnectionHandler::MAVLinkConnectionHandler(io_service& service, ConnectionTarget target) : 
-    tcp_acceptor(service, (int)target) {
+    tcp_acceptor(service, (int)target),
+    frames_in_metric(MetricsRegistry::shared_instance().msgid_counters("sim6dof_mavlink_frames_total", "MAVLink frames by message id", "direction=\"in\"")),
+    frames_out_metric(MetricsRegistry::shared_instance().msgid_counters("sim6dof_mavlink_frames_total", "MAVLink frames by message id", "direction=\"out\"")),
+    send_errors_metric(MetricsRegistry::shared_instance().counter("sim6dof_mavlink_send_errors_total", "MAVLink frames that could not be written to the autopilot link")) {
         this->tcp_acceptor.add_data_receiver(this);
         this->new_message_signal.connect(boost::bind(&MAVLinkConnectionHandler::send_message, this, _1));
 }
 
 MAVLinkConnectionHandler::~MAVLinkConnectionHandler() {}
 
-bool MAVLinkConnectionHandler::parse_mavlink_message(const char* buff, size_t len, mavlink_message_t& msg, mavlink_status_t& status) {
-    for (auto i = 0; i < len; i++) {
-        if (mavlink_parse_char(MAVLINK_COMM_0,buff[i], &msg, &status)) return true;
-    }
-    return false;
-}
-
 void MAVLinkConnectionHandler::receive_data(const char* buff, size_t len) {
     mavlink_message_t msg;
     mavlink_status_t status;
-    if (this->parse_mavlink_message(buff, len, msg, status)) {
-        this->received_message(msg);
+    // A single read can carry several frames (e.g. PX4 catching up after a hiccup): dispatch all of them
+    for (size_t i = 0; i < len; i++) {
+        if (mavlink_parse_char(MAVLINK_COMM_0, buff[i], &msg, &status)) this->received_message(msg);
     }
 }
 
@@ -33,24 +32,30 @@ size_t MAVLinkConnectionHandler::send_data(const void* buff, size_t len) {
 }
 
 bool MAVLinkConnectionHandler::received_message(mavlink_message_t m) {
-    for (auto h : this->message_handlers) {
-        h->handle_mavlink_message(m);
-    }
+    TraceScope trace_scope("MAVLink receive", m.msgid);
+    this->frames_in_metric.increment(m.msgid);
+    if (this->capture_writer != NULL) this->capture_writer->record(MAVLinkCaptureDirection::INBOUND, m);
+    this->dispatch_table.dispatch(m);
     return true;
 }
 
-void MAVLinkConnectionHandler::enqueue_message(const mavlink_message_t m) {
+void MAVLinkConnectionHandler::enqueue_message(const mavlink_message_t& m) {
     this->new_message_signal(m);
 }
 
 bool MAVLinkConnectionHandler::send_message(const mavlink_message_t& m) {
 #define MAX_MAVLINK_MESSAGE_SIZE 300
+    ProfileScope scope(PROFILE_SOCKET_SEND);
+    TraceScope trace_scope("MAVLink send", m.msgid);
+
+    if (this->capture_writer != NULL) this->capture_writer->record(MAVLinkCaptureDirection::OUTBOUND, m);
 
     uint8_t buf[MAX_MAVLINK_MESSAGE_SIZE];
     u_int16_t len = mavlink_msg_to_send_buffer(buf, &m);
     int bytes_sent = this->tcp_acceptor.send_data(&buf, len);
-    if (bytes_sent > 0) ; //fprintf(stdout, "Sent mavlink message (%d bytes)\n", bytes_sent);
+    if (bytes_sent > 0) this->frames_out_metric.increment(m.msgid); //fprintf(stdout, "Sent mavlink message (%d bytes)\n", bytes_sent);
     else {
+        this->send_errors_metric.increment();
         c->debug_log("Error in sending MAVLink message.\n");
         return false;
     }
@@ -62,5 +67,9 @@ bool MAVLinkConnectionHandler::connection_open() {
 }
 
 void MAVLinkConnectionHandler::add_message_handler(MAVLinkMessageHandler* h) {
-    this->message_handlers.push_back(h);
+    this->dispatch_table.subscribe(h);
+}
+
+void MAVLinkConnectionHandler::add_message_handler(MAVLinkMessageHandler* h, uint32_t msgid) {
+    this->dispatch_table.subscribe(h, msgid);
 }
\ No newline at end of file
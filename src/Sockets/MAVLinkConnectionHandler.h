@@ -8,6 +8,9 @@
 #include "../Interfaces/MAVLinkMessageHandler.h"
 #include "TCPAcceptor.h"
 #include "../Interfaces/MAVLinkMessageRelay.h"
+#include "../Logging/MAVLinkCapture.h"
+#include "MAVLinkDispatchTable.h"
+#include "../Metrics/MetricsRegistry.h"
 
 #define MAX_MAVLINK_PACKET_LEN 512
 
@@ -26,19 +29,24 @@ private:
     uint buffer_read_head = 0;
     uint buffer_parse_head = 0;
     TCPAcceptor tcp_acceptor;
-    boost::signals2::signal<void(mavlink_message_t)> new_message_signal;
-    std::vector<MAVLinkMessageHandler*> message_handlers;
-    bool parse_mavlink_message(const char* buff, size_t len, mavlink_message_t& msg, mavlink_status_t& status);
+    boost::signals2::signal<void(const mavlink_message_t&)> new_message_signal;
+    MAVLinkDispatchTable dispatch_table;
+    MAVLinkCaptureWriter* capture_writer = NULL;
+    MsgidCounters& frames_in_metric;
+    MsgidCounters& frames_out_metric;
+    Counter& send_errors_metric;
     bool send_message(const mavlink_message_t& m) override;
 public:
     MAVLinkConnectionHandler(io_service& service, ConnectionTarget target);    
     ~MAVLinkConnectionHandler();
     void add_message_handler(MAVLinkMessageHandler* h) override;
-    void handle_mavlink_message(mavlink_message_t m);
+    void add_message_handler(MAVLinkMessageHandler* h, uint32_t msgid) override;
+    // Records every inbound and outbound frame (NULL disables recording)
+    void set_capture_writer(MAVLinkCaptureWriter* writer) { this->capture_writer = writer; }
     void receive_data(const char* buff, size_t len) override;
     size_t send_data(const void* buff, size_t len) override;
     bool received_message(mavlink_message_t m) override;
-    void enqueue_message(mavlink_message_t m) override;
+    void enqueue_message(const mavlink_message_t& m) override;
     bool connection_open() override;
 };
 
@@ -0,0 +1,49 @@
+#ifndef __MAVLINKDISPATCHTABLE_H__
+#define __MAVLINKDISPATCHTABLE_H__
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <mavlink.h>
+#include "../Interfaces/MAVLinkMessageHandler.h"
+
+// Message ids below this bound are routed through a directly indexed table
+#define MAVLINK_DISPATCH_DIRECT_IDS 256
+
+/**
+ * Routes MAVLink frames to the handlers subscribed to their message id.
+ * Handlers subscribed without an id receive every frame.
+ *
+ * Subscriptions are expected to happen during setup, before frames flow:
+ * dispatch() does not lock.
+ */
+class MAVLinkDispatchTable {
+private:
+    std::array<std::vector<MAVLinkMessageHandler*>, MAVLINK_DISPATCH_DIRECT_IDS> direct;
+    std::unordered_map<uint32_t, std::vector<MAVLinkMessageHandler*>> extended;
+    std::vector<MAVLinkMessageHandler*> wildcard;
+public:
+    void subscribe(MAVLinkMessageHandler* h) {
+        this->wildcard.push_back(h);
+    }
+
+    void subscribe(MAVLinkMessageHandler* h, uint32_t msgid) {
+        if (msgid < MAVLINK_DISPATCH_DIRECT_IDS) this->direct[msgid].push_back(h);
+        else this->extended[msgid].push_back(h);
+    }
+
+    void dispatch(const mavlink_message_t& m) const {
+        for (auto h : this->wildcard) h->handle_mavlink_message(m);
+
+        if (m.msgid < MAVLINK_DISPATCH_DIRECT_IDS) {
+            for (auto h : this->direct[m.msgid]) h->handle_mavlink_message(m);
+            return;
+        }
+        if (this->extended.empty()) return;
+        auto it = this->extended.find(m.msgid);
+        if (it == this->extended.end()) return;
+        for (auto h : it->second) h->handle_mavlink_message(m);
+    }
+};
+
+#endif // __MAVLINKDISPATCHTABLE_H__
@@ -0,0 +1,72 @@
+#include "MAVLinkReplayRelay.h"
+
+MAVLinkReplayRelay::MAVLinkReplayRelay(const std::vector<MAVLinkCaptureRecord>& records, Clock& clock) :
+    clock(clock) {
+        for (auto& r : records) {
+            if (r.direction == MAVLinkCaptureDirection::INBOUND) this->inbound.push_back(r);
+        }
+}
+
+boost::chrono::microseconds MAVLinkReplayRelay::get_capture_duration_us() {
+    if (this->inbound.empty()) return boost::chrono::microseconds{0};
+    return boost::chrono::microseconds{this->inbound.back().sim_time_us};
+}
+
+void MAVLinkReplayRelay::update(__attribute__((unused)) boost::chrono::microseconds us) {
+    boost::chrono::microseconds now = this->clock.get_current_time_us();
+    uint64_t released = 0;
+
+    while (!this->finished() && this->inbound[this->cursor].sim_time_us <= (uint64_t)now.count()) {
+        this->received_message(this->inbound[this->cursor++].message);
+        released++;
+    }
+
+    // The clock did not advance since the last tick (systems are waiting on lockstep)
+    // and nothing is due: release the next frame so the replay cannot stall.
+    if (released == 0 && now == this->last_update_time) {
+        if (!this->finished()) this->received_message(this->inbound[this->cursor++].message);
+        // Capture exhausted -- let time run out instead of waiting for frames that will never come
+        else this->clock.unlock_time();
+    }
+
+    this->last_update_time = now;
+}
+
+std::string MAVLinkReplayRelay::str() {
+    return std::string(
+        "<MAVLinkReplayRelay frames: " +
+        std::to_string(this->cursor) +
+        "/" +
+        std::to_string(this->inbound.size()) +
+        " >"
+    );
+}
+
+bool MAVLinkReplayRelay::received_message(mavlink_message_t m) {
+    this->frames_in++;
+    if (this->capture_writer != NULL) this->capture_writer->record(MAVLinkCaptureDirection::INBOUND, m);
+    this->dispatch_table.dispatch(m);
+    return true;
+}
+
+bool MAVLinkReplayRelay::send_message(const mavlink_message_t& m) {
+    this->frames_out++;
+    if (this->capture_writer != NULL) this->capture_writer->record(MAVLinkCaptureDirection::OUTBOUND, m);
+    return true;
+}
+
+void MAVLinkReplayRelay::enqueue_message(const mavlink_message_t& m) {
+    this->send_message(m);
+}
+
+void MAVLinkReplayRelay::add_message_handler(MAVLinkMessageHandler* h) {
+    this->dispatch_table.subscribe(h);
+}
+
+void MAVLinkReplayRelay::add_message_handler(MAVLinkMessageHandler* h, uint32_t msgid) {
+    this->dispatch_table.subscribe(h, msgid);
+}
+
+bool MAVLinkReplayRelay::connection_open() {
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef __MAVLINKREPLAYRELAY_H__
+#define __MAVLINKREPLAYRELAY_H__
+
+#include <vector>
+#include <mavlink.h>
+#include "../Interfaces/MAVLinkMessageRelay.h"
+#include "../Interfaces/MAVLinkMessageHandler.h"
+#include "../Interfaces/EnvironmentObject.h"
+#include "../Interfaces/Clock.h"
+#include "../Logging/MAVLinkCapture.h"
+#include "MAVLinkDispatchTable.h"
+
+/**
+ * Socketless MAVLink relay that feeds the inbound frames of a capture
+ * back to its handlers, keyed on the simulation time they were received at.
+ *
+ * Must be added to the simulator *before* the systems it feeds so that
+ * the frames of a tick are queued before the systems process their messages.
+ */
+class MAVLinkReplayRelay :
+    public MAVLinkMessageRelay,
+    public EnvironmentObject {
+private:
+    std::vector<MAVLinkCaptureRecord> inbound;
+    MAVLinkDispatchTable dispatch_table;
+    Clock& clock;
+    MAVLinkCaptureWriter* capture_writer = NULL;
+
+    size_t cursor = 0;
+    uint64_t frames_in = 0;
+    uint64_t frames_out = 0;
+    boost::chrono::microseconds last_update_time{-1};
+public:
+    MAVLinkReplayRelay(const std::vector<MAVLinkCaptureRecord>& records, Clock& clock);
+
+    void set_capture_writer(MAVLinkCaptureWriter* writer) { this->capture_writer = writer; }
+
+    bool finished() { return this->cursor >= this->inbound.size(); }
+    uint64_t get_frames_in() { return this->frames_in; }
+    uint64_t get_frames_out() { return this->frames_out; }
+    // Simulation time of the last inbound frame of the capture
+    boost::chrono::microseconds get_capture_duration_us();
+
+    void update(boost::chrono::microseconds us) override;
+    std::string str() override;
+
+    bool received_message(mavlink_message_t m) override;
+    bool send_message(const mavlink_message_t& m) override;
+    void enqueue_message(const mavlink_message_t& m) override;
+    void add_message_handler(MAVLinkMessageHandler* h) override;
+    void add_message_handler(MAVLinkMessageHandler* h, uint32_t msgid) override;
+    bool connection_open() override;
+};
+
+#endif // __MAVLINKREPLAYRELAY_H__
@@ -26,6 +26,9 @@ void TCPAcceptor::start()
 
 void TCPAcceptor::handle_accept(TCPConnection::tcp_connection_ptr conn, const boost::system::error_code& err) {
     printf("Accepted new connection.\n");
+    // Lockstep sends many small frames per tick: do not let Nagle hold them back
+    boost::system::error_code option_err;
+    conn->get_socket().set_option(boost::asio::ip::tcp::no_delay(true), option_err);
 }
 
 void TCPAcceptor::receive_data(const char* buff, size_t len) {
@@ -6,15 +6,14 @@
 #include "Interfaces/DroneController.h"
 #include "DroneSensors.h"
 #include "DataStructures/LatLonAlt.h"
-#include "Containers/DroneConfig.h"
+#include "Containers/ConfigRegistry.h"
 #include "Interfaces/DroneStateProcessor.h"
 
 class StandaloneDrone : public DynamicObject {
 protected:
     DroneStateProcessor* drone_state_processor;
 
-    DroneConfig config;
-    SimpleFixedWingESC virtual_esc{config};
+    SimpleFixedWingESC virtual_esc{this->shared_config};
     DroneController& controller;
 
 // Glasgow LatLon Height
@@ -27,13 +26,15 @@ protected:
     };
 
     void _setup_drone();
-    void fake_ground_transform(boost::chrono::microseconds us);
     void mix_controls(boost::chrono::microseconds us);
     
 public:
+    // `config_file` is parsed once per process (see ConfigRegistry)
     StandaloneDrone(const char* config_file, Clock& clock, DroneController& controller) :
-        DynamicObject(config_from_file_path(config_file), clock),
-        config(config_from_file_path(config_file)),
+        StandaloneDrone(ConfigRegistry::shared_instance().get(config_file), clock, controller) {};
+
+    StandaloneDrone(std::shared_ptr<const DroneConfig> config, Clock& clock, DroneController& controller) :
+        DynamicObject(config, clock),
         controller(controller)
         { this->_setup_drone(); };
     
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include "DEMTerrain.h"
+
+static size_t node_count(const DEMTileHeader& header) {
+    return (size_t)header.points[0] * header.points[1];
+}
+
+DEMTerrain::DEMTerrain(const char* path) {
+    memset(&this->header, 0, sizeof(this->header));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Could not open DEM tile %s\n", path);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DEMTileHeader)) {
+        fprintf(stderr, "Invalid DEM tile %s\n", path);
+        close(fd);
+        return;
+    }
+
+    void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Could not map DEM tile %s\n", path);
+        return;
+    }
+
+    memcpy(&this->header, mapping, sizeof(this->header));
+    bool valid = strncmp(this->header.magic, DEM_TILE_MAGIC, sizeof(this->header.magic)) == 0 &&
+        this->header.version == DEM_TILE_VERSION &&
+        this->header.points[0] > 0 && this->header.points[1] > 0 &&
+        (size_t)st.st_size == sizeof(DEMTileHeader) + node_count(this->header) * sizeof(float);
+    if (!valid) {
+        fprintf(stderr, "Invalid DEM tile %s\n", path);
+        munmap(mapping, st.st_size);
+        return;
+    }
+
+    this->mapping = mapping;
+    this->mapping_size = st.st_size;
+    this->nodes = (const float*)((const char*)mapping + sizeof(DEMTileHeader));
+    for (int i = 0; i < 2; i++) {
+        this->inv_spacing[i] = this->header.spacing[i] > 0 ? 1.0 / this->header.spacing[i] : 0;
+    }
+}
+
+DEMTerrain::~DEMTerrain() {
+    if (this->mapping != NULL) munmap(this->mapping, this->mapping_size);
+}
+
+bool DEMTerrain::write(const char* path, DEMTileHeader header, const std::vector<float>& elevations) {
+    strncpy(header.magic, DEM_TILE_MAGIC, sizeof(header.magic));
+    header.version = DEM_TILE_VERSION;
+    if (elevations.size() != node_count(header)) {
+        fprintf(stderr, "DEM tile node count does not match its header\n");
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Could not write DEM tile %s\n", path);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(elevations.data(), sizeof(float), elevations.size(), file) == elevations.size();
+    fclose(file);
+    return ok;
+}
+
+double DEMTerrain::elevation_at(double north, double east) const {
+    if (this->nodes == NULL) return 0;
+
+    const double position[2] = {north, east};
+    uint32_t index[2];
+    double weight[2];
+    for (int i = 0; i < 2; i++) {
+        uint32_t points = this->header.points[i];
+        double f = (position[i] - this->header.origin[i]) * this->inv_spacing[i];
+        f = std::max(0.0, std::min(f, (double)(points - 1)));
+        // Single node axes have nothing to interpolate
+        index[i] = points > 1 ? std::min((uint32_t)f, points - 2) : 0;
+        weight[i] = points > 1 ? f - index[i] : 0;
+    }
+
+    const size_t dn = this->header.points[0] > 1 ? 1 : 0;
+    const size_t de = this->header.points[1] > 1 ? this->header.points[0] : 0;
+    const float* c = this->nodes + (size_t)index[1] * this->header.points[0] + index[0];
+
+    double c0 = c[0] + weight[0] * (c[dn] - c[0]);
+    double c1 = c[de] + weight[0] * (c[de + dn] - c[de]);
+    return c0 + weight[1] * (c1 - c0);
+}
@@ -0,0 +1,59 @@
+#ifndef __DEMTERRAIN_H__
+#define __DEMTERRAIN_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "Terrain.h"
+
+/**
+ * Binary DEM tile format.
+ *
+ * Header:  DEMTileHeader ("6DOFDEM" magic, version, grid geometry)
+ * Body:    float elevation (m, up, relative to the NED origin) per node,
+ *          north fastest, then east
+ *
+ * All values are stored in host byte order; the file is mapped as is.
+ */
+#define DEM_TILE_MAGIC "6DOFDEM"
+#define DEM_TILE_VERSION 1
+
+struct DEMTileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    double origin[2];       // north, east position of the first node (m)
+    double spacing[2];      // node spacing along north, east (m)
+    uint32_t points[2];     // nodes along north, east
+};
+
+/**
+ * Terrain backed by a memory mapped DEM tile, sampled with bilinear interpolation.
+ * Positions outside the tile are clamped to its boundary.
+ */
+class DEMTerrain : public Terrain {
+private:
+    DEMTileHeader header;
+    const float* nodes = NULL;
+    void* mapping = NULL;
+    size_t mapping_size = 0;
+    double inv_spacing[2];
+public:
+    DEMTerrain(const char* path);
+    ~DEMTerrain();
+    DEMTerrain(DEMTerrain& t) = delete;
+
+    // False when the file could not be mapped (the terrain is then flat at the origin)
+    bool is_loaded() const { return this->nodes != NULL; }
+    const DEMTileHeader& get_header() const { return this->header; }
+
+    double elevation_at(double north, double east) const override;
+
+    /**
+     * Writes a DEM tile, e.g. resampled from SRTM around the GPS origin.
+     * Magic and version of `header` are filled in.
+     */
+    static bool write(const char* path, DEMTileHeader header, const std::vector<float>& elevations);
+};
+
+#endif // __DEMTERRAIN_H__
@@ -0,0 +1,28 @@
+#ifndef __TERRAIN_H__
+#define __TERRAIN_H__
+
+/**
+ * Ground height source: elevation (m, up) of the ground above the NED origin
+ * at a north / east position (m).
+ *
+ * Implementations are immutable once set up, so elevation_at() can be called
+ * from any thread, at every integration stage.
+ */
+class Terrain {
+public:
+    virtual ~Terrain() {}
+    virtual double elevation_at(double north, double east) const = 0;
+};
+
+class FlatTerrain : public Terrain {
+private:
+    double elevation;
+public:
+    FlatTerrain(double elevation = 0) : elevation(elevation) {}
+
+    double elevation_at(double north, double east) const override {
+        return this->elevation;
+    }
+};
+
+#endif // __TERRAIN_H__
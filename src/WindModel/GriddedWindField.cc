@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include "GriddedWindField.h"
+
+static size_t node_count(const GriddedWindHeader& header) {
+    return (size_t)header.points[0] * header.points[1] * header.points[2] * header.frames;
+}
+
+GriddedWindField::GriddedWindField(const char* path) {
+    memset(&this->header, 0, sizeof(this->header));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Could not open wind field file %s\n", path);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(GriddedWindHeader)) {
+        fprintf(stderr, "Invalid wind field file %s\n", path);
+        close(fd);
+        return;
+    }
+
+    void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Could not map wind field file %s\n", path);
+        return;
+    }
+
+    memcpy(&this->header, mapping, sizeof(this->header));
+    bool valid = strncmp(this->header.magic, GRIDDED_WIND_MAGIC, sizeof(this->header.magic)) == 0 &&
+        this->header.version == GRIDDED_WIND_VERSION &&
+        this->header.frames > 0 &&
+        this->header.points[0] > 0 && this->header.points[1] > 0 && this->header.points[2] > 0 &&
+        (size_t)st.st_size == sizeof(GriddedWindHeader) + node_count(this->header) * 3 * sizeof(float);
+    if (!valid) {
+        fprintf(stderr, "Invalid wind field file %s\n", path);
+        munmap(mapping, st.st_size);
+        return;
+    }
+
+    this->mapping = mapping;
+    this->mapping_size = st.st_size;
+    this->nodes = (const float*)((const char*)mapping + sizeof(GriddedWindHeader));
+    for (int i = 0; i < 3; i++) {
+        this->inv_spacing[i] = this->header.spacing[i] > 0 ? 1.0 / this->header.spacing[i] : 0;
+    }
+}
+
+GriddedWindField::~GriddedWindField() {
+    if (this->mapping != NULL) munmap(this->mapping, this->mapping_size);
+}
+
+bool GriddedWindField::write(const char* path, GriddedWindHeader header, const std::vector<float>& nodes) {
+    strncpy(header.magic, GRIDDED_WIND_MAGIC, sizeof(header.magic));
+    header.version = GRIDDED_WIND_VERSION;
+    if (nodes.size() != node_count(header) * 3) {
+        fprintf(stderr, "Wind field node count does not match its header\n");
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Could not write wind field file %s\n", path);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(nodes.data(), sizeof(float), nodes.size(), file) == nodes.size();
+    fclose(file);
+    return ok;
+}
+
+Eigen::Vector3d GriddedWindField::_sample_frame(const float* frame, const Eigen::Vector3d& ned_position) const {
+    uint32_t index[3];
+    double weight[3];
+    for (int i = 0; i < 3; i++) {
+        uint32_t points = this->header.points[i];
+        double f = (ned_position[i] - this->header.origin[i]) * this->inv_spacing[i];
+        f = std::max(0.0, std::min(f, (double)(points - 1)));
+        // Single node axes have nothing to interpolate
+        index[i] = points > 1 ? std::min((uint32_t)f, points - 2) : 0;
+        weight[i] = points > 1 ? f - index[i] : 0;
+    }
+
+    const size_t north_stride = 3;
+    const size_t east_stride = (size_t)this->header.points[0] * north_stride;
+    const size_t down_stride = (size_t)this->header.points[1] * east_stride;
+    // Neighbour offsets (zero along single node axes)
+    const size_t dn = this->header.points[0] > 1 ? north_stride : 0;
+    const size_t de = this->header.points[1] > 1 ? east_stride : 0;
+    const size_t dd = this->header.points[2] > 1 ? down_stride : 0;
+    const float* c = frame + index[2] * down_stride + index[1] * east_stride + index[0] * north_stride;
+
+    Eigen::Vector3d wind;
+    for (int k = 0; k < 3; k++) {
+        double c00 = c[k] + weight[0] * (c[dn + k] - c[k]);
+        double c10 = c[de + k] + weight[0] * (c[de + dn + k] - c[de + k]);
+        double c01 = c[dd + k] + weight[0] * (c[dd + dn + k] - c[dd + k]);
+        double c11 = c[dd + de + k] + weight[0] * (c[dd + de + dn + k] - c[dd + de + k]);
+        double c0 = c00 + weight[1] * (c10 - c00);
+        double c1 = c01 + weight[1] * (c11 - c01);
+        wind[k] = c0 + weight[2] * (c1 - c0);
+    }
+    return wind;
+}
+
+Eigen::Vector3d GriddedWindField::wind_at(const Eigen::Vector3d& ned_position, double t) const {
+    if (this->nodes == NULL) return Eigen::Vector3d::Zero();
+
+    const size_t frame_size = (size_t)this->header.points[0] * this->header.points[1] * this->header.points[2] * 3;
+    if (this->header.frames == 1 || this->header.frame_interval <= 0) {
+        return this->_sample_frame(this->nodes, ned_position);
+    }
+
+    double f = (t - this->header.start_time) / this->header.frame_interval;
+    f = std::max(0.0, std::min(f, (double)(this->header.frames - 1)));
+    uint32_t frame = std::min((uint32_t)f, this->header.frames - 2);
+    double weight = f - frame;
+
+    Eigen::Vector3d before = this->_sample_frame(this->nodes + frame * frame_size, ned_position);
+    Eigen::Vector3d after = this->_sample_frame(this->nodes + (frame + 1) * frame_size, ned_position);
+    return before + weight * (after - before);
+}
@@ -0,0 +1,66 @@
+#ifndef __GRIDDEDWINDFIELD_H__
+#define __GRIDDEDWINDFIELD_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "WindField.h"
+
+/**
+ * Binary gridded wind file format.
+ *
+ * Header:  GriddedWindHeader ("6DOFWND" magic, version, grid geometry)
+ * Body:    float[3] (north, east, down wind in m/s) per node, north fastest,
+ *          then east, then down, then time frame
+ *
+ * All values are stored in host byte order; the file is mapped as is.
+ */
+#define GRIDDED_WIND_MAGIC "6DOFWND"
+#define GRIDDED_WIND_VERSION 1
+
+struct GriddedWindHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    double origin[3];       // NED position of the first node (m)
+    double spacing[3];      // node spacing along north, east, down (m)
+    double start_time;      // time of the first frame (s)
+    double frame_interval;  // time between frames (s)
+    uint32_t points[3];     // nodes along north, east, down
+    uint32_t frames;
+};
+
+/**
+ * Time-varying 3D wind field backed by a memory mapped file.
+ *
+ * Sampled with trilinear interpolation in space and linear interpolation in time.
+ * Positions and times outside the grid are clamped to its boundary.
+ */
+class GriddedWindField : public WindField {
+private:
+    GriddedWindHeader header;
+    const float* nodes = NULL;
+    void* mapping = NULL;
+    size_t mapping_size = 0;
+    double inv_spacing[3];
+
+    Eigen::Vector3d _sample_frame(const float* frame, const Eigen::Vector3d& ned_position) const;
+public:
+    GriddedWindField(const char* path);
+    ~GriddedWindField();
+    GriddedWindField(GriddedWindField& g) = delete;
+
+    // False when the file could not be mapped (the field then reports no wind)
+    bool is_loaded() const { return this->nodes != NULL; }
+    const GriddedWindHeader& get_header() const { return this->header; }
+
+    Eigen::Vector3d wind_at(const Eigen::Vector3d& ned_position, double t) const override;
+
+    /**
+     * Writes a wind file, e.g. exported from a CFD or mesoscale model run.
+     * Magic and version of `header` are filled in.
+     */
+    static bool write(const char* path, GriddedWindHeader header, const std::vector<float>& nodes);
+};
+
+#endif // __GRIDDEDWINDFIELD_H__
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <algorithm>
+#include "TurbulenceModel.h"
+
+#define FT_TO_M 0.3048
+#define M_TO_FT (1.0 / FT_TO_M)
+#define TURBULENCE_MIN_AIRSPEED 0.5 // m/s
+// Low altitude model below 1000 ft, scale length blends to 1750 ft by 2000 ft
+#define TURBULENCE_LOW_ALTITUDE_FT 1000.0
+#define TURBULENCE_HIGH_ALTITUDE_FT 2000.0
+#define TURBULENCE_HIGH_ALTITUDE_SCALE_FT 1750.0
+
+// Spectra as N(tau s) / D(tau s), tau = L / V
+static const double DRYDEN_U_NUM[] = {1};
+static const double DRYDEN_U_DEN[] = {1, 1};
+static const double DRYDEN_VW_NUM[] = {1, 1.7320508075688772};
+static const double DRYDEN_VW_DEN[] = {1, 2, 1};
+static const double VON_KARMAN_U_NUM[] = {1, 0.25};
+static const double VON_KARMAN_U_DEN[] = {1, 1.357, 0.1987};
+static const double VON_KARMAN_VW_NUM[] = {1, 2.7478, 0.3398};
+static const double VON_KARMAN_VW_DEN[] = {1, 2.9958, 1.9754, 0.1539};
+
+#pragma mark ShapingFilter
+
+ShapingFilter::ShapingFilter(const double* numerator, int numerator_size, const double* denominator, int denominator_size) {
+    for (int i = 0; i < numerator_size; i++) this->numerator[i] = numerator[i];
+    for (int i = 0; i < denominator_size; i++) this->denominator[i] = denominator[i];
+    this->order = denominator_size - 1;
+}
+
+/**
+ * Controllable canonical form of 1 / D(s): x_k = s^k x_0, the output is K * sum(n_k tau^k x_k).
+ * Integrated with explicit Euler sub-steps short enough for the fastest pole;
+ * the noise is scaled so that the output variance matches the (one-sided) spectrum.
+ */
+double ShapingFilter::step(double dt, double gain, double tau, std::mt19937& gen, std::normal_distribution<double>& nd) {
+    const int n = this->order;
+    double den[4], num[3];
+    double tau_k = 1;
+    for (int k = 0; k <= n; k++) {
+        den[k] = this->denominator[k] * tau_k;
+        if (k < 3) num[k] = this->numerator[k] * tau_k;
+        tau_k *= tau;
+    }
+
+    // Sum of the pole magnitudes bounds the fastest one
+    double h_max = 0.1 * den[n] / den[n - 1];
+    int substeps = std::max(1, (int)std::ceil(dt / h_max));
+    double h = dt / substeps;
+
+    for (int s = 0; s < substeps; s++) {
+        double u = nd(gen) * std::sqrt(M_PI / h);
+        double highest = u;
+        for (int k = 0; k < n; k++) highest -= den[k] * this->state[k];
+        highest /= den[n];
+        for (int k = 0; k < n - 1; k++) this->state[k] += h * this->state[k + 1];
+        this->state[n - 1] += h * highest;
+    }
+
+    double y = 0;
+    for (int k = 0; k < n && k < 3; k++) y += num[k] * this->state[k];
+    return gain * y;
+}
+
+#pragma mark TurbulenceModel
+
+TurbulenceModel::TurbulenceModel(const TurbulenceConfig& config) : config(config) {
+    this->gen.seed(config.seed != 0 ? config.seed : std::random_device{}());
+    if (config.spectrum == VON_KARMAN) {
+        this->u_filter = ShapingFilter(VON_KARMAN_U_NUM, 2, VON_KARMAN_U_DEN, 3);
+        this->v_filter = ShapingFilter(VON_KARMAN_VW_NUM, 3, VON_KARMAN_VW_DEN, 4);
+        this->w_filter = ShapingFilter(VON_KARMAN_VW_NUM, 3, VON_KARMAN_VW_DEN, 4);
+    } else {
+        this->u_filter = ShapingFilter(DRYDEN_U_NUM, 1, DRYDEN_U_DEN, 2);
+        this->v_filter = ShapingFilter(DRYDEN_VW_NUM, 2, DRYDEN_VW_DEN, 3);
+        this->w_filter = ShapingFilter(DRYDEN_VW_NUM, 2, DRYDEN_VW_DEN, 3);
+    }
+}
+
+const Eigen::Vector3d& TurbulenceModel::step(double dt, double airspeed, double altitude_m) {
+    if (this->config.wind_speed_20ft <= 0 || dt <= 0) return this->gust;
+
+    double V = std::max(airspeed, TURBULENCE_MIN_AIRSPEED);
+    double h_ft = std::max(10.0, altitude_m * M_TO_FT);
+    double h_low = std::min(h_ft, TURBULENCE_LOW_ALTITUDE_FT);
+
+    // MIL-F-8785C low altitude scale lengths (ft) and intensities
+    double k = 0.177 + 0.000823 * h_low;
+    double L_u = h_low / std::pow(k, 1.2);
+    double L_w = h_low;
+    if (h_ft > TURBULENCE_LOW_ALTITUDE_FT) {
+        double blend = std::min(1.0, (h_ft - TURBULENCE_LOW_ALTITUDE_FT) / (TURBULENCE_HIGH_ALTITUDE_FT - TURBULENCE_LOW_ALTITUDE_FT));
+        L_u += blend * (TURBULENCE_HIGH_ALTITUDE_SCALE_FT - L_u);
+        L_w += blend * (TURBULENCE_HIGH_ALTITUDE_SCALE_FT - L_w);
+    }
+    L_u *= FT_TO_M;
+    L_w *= FT_TO_M;
+    double sigma_w = 0.1 * this->config.wind_speed_20ft;
+    double sigma_u = sigma_w / std::pow(k, 0.4);
+
+    double tau_u = L_u / V;
+    double tau_w = L_w / V;
+    this->gust[0] = this->u_filter.step(dt, sigma_u * std::sqrt(2 * tau_u / M_PI), tau_u, this->gen, this->nd);
+    this->gust[1] = this->v_filter.step(dt, sigma_u * std::sqrt(tau_u / M_PI), tau_u, this->gen, this->nd);
+    this->gust[2] = this->w_filter.step(dt, sigma_w * std::sqrt(tau_w / M_PI), tau_w, this->gen, this->nd);
+    return this->gust;
+}
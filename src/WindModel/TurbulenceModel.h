@@ -0,0 +1,68 @@
+#ifndef __TURBULENCEMODEL_H__
+#define __TURBULENCEMODEL_H__
+
+#include <stdint.h>
+#include <random>
+#include <Eigen/Eigen>
+
+enum TurbulenceSpectrum {
+    DRYDEN,
+    VON_KARMAN
+};
+
+struct TurbulenceConfig {
+    TurbulenceSpectrum spectrum = DRYDEN;
+    // Mean wind speed at 20 ft (m/s), sets the intensity (MIL-F-8785C: light 7.7, moderate 15.4, severe 23.1)
+    double wind_speed_20ft = 0;
+    // 0 seeds from std::random_device
+    uint32_t seed = 0;
+};
+
+/**
+ * Rational shaping filter K * N(tau s) / D(tau s) driven by white noise,
+ * with numerator up to 2nd order and denominator up to 3rd order (D(0) = 1).
+ */
+class ShapingFilter {
+private:
+    double numerator[3] = {0};
+    double denominator[4] = {0};
+    int order = 1;
+    double state[3] = {0};
+public:
+    ShapingFilter() {}
+    ShapingFilter(const double* numerator, int numerator_size, const double* denominator, int denominator_size);
+
+    /**
+     * Advances the filter by dt with a white noise of unit intensity.
+     * @param gain  K
+     * @param tau   time scale L / V (s)
+     */
+    double step(double dt, double gain, double tau, std::mt19937& gen, std::normal_distribution<double>& nd);
+};
+
+/**
+ * Continuous gust model (MIL-F-8785C) generating body frame turbulence by
+ * filtering white noise through Dryden or (rational approximations of) von Karman spectra.
+ *
+ * Stateful: each vehicle owns its own model, stepped once per tick.
+ */
+class TurbulenceModel {
+private:
+    TurbulenceConfig config;
+    ShapingFilter u_filter, v_filter, w_filter;
+    std::mt19937 gen;
+    std::normal_distribution<double> nd{0, 1};
+    Eigen::Vector3d gust{0, 0, 0};
+public:
+    TurbulenceModel(const TurbulenceConfig& config);
+
+    /**
+     * @param airspeed      m/s (clamped to a small positive value in hover)
+     * @param altitude_m    height above ground (m)
+     * @return body frame gust velocity (m/s)
+     */
+    const Eigen::Vector3d& step(double dt, double airspeed, double altitude_m);
+    const Eigen::Vector3d& get_gust() const { return this->gust; }
+};
+
+#endif // __TURBULENCEMODEL_H__
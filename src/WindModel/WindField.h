@@ -0,0 +1,53 @@
+#ifndef __WINDFIELD_H__
+#define __WINDFIELD_H__
+
+#include <cmath>
+#include <Eigen/Eigen>
+
+/**
+ * Deterministic wind component: wind velocity (NED, m/s) as a function of
+ * NED position (m) and simulation time (s).
+ *
+ * Implementations are immutable once set up, so wind_at() can be called from
+ * any thread, at every integration stage.
+ */
+class WindField {
+public:
+    virtual ~WindField() {}
+    virtual Eigen::Vector3d wind_at(const Eigen::Vector3d& ned_position, double t) const = 0;
+};
+
+class ConstantWind : public WindField {
+private:
+    Eigen::Vector3d wind;
+public:
+    ConstantWind(const Eigen::Vector3d& wind_ned) : wind(wind_ned) {}
+
+    Eigen::Vector3d wind_at(const Eigen::Vector3d& ned_position, double t) const override {
+        return this->wind;
+    }
+};
+
+/**
+ * Discrete "1 - cosine" gust: ramps from zero to `peak` and back over `duration` seconds,
+ * starting at `start_time`.
+ */
+class GustProfile : public WindField {
+private:
+    Eigen::Vector3d peak;
+    double start_time;
+    double duration;
+public:
+    GustProfile(const Eigen::Vector3d& peak_ned, double start_time, double duration) :
+        peak(peak_ned),
+        start_time(start_time),
+        duration(duration) {}
+
+    Eigen::Vector3d wind_at(const Eigen::Vector3d& ned_position, double t) const override {
+        double elapsed = t - this->start_time;
+        if (elapsed <= 0 || elapsed >= this->duration) return Eigen::Vector3d::Zero();
+        return this->peak * 0.5 * (1 - cos(2 * M_PI * elapsed / this->duration));
+    }
+};
+
+#endif // __WINDFIELD_H__
@@ -0,0 +1,20 @@
+#include "WindService.h"
+
+std::unique_ptr<TurbulenceModel> WindService::make_turbulence() {
+    if (!this->has_turbulence()) return nullptr;
+    TurbulenceConfig config = this->turbulence_config;
+    uint32_t n = this->turbulence_models_n.fetch_add(1);
+    // Reproducible when seeded, but never the same sequence for two vehicles
+    if (config.seed != 0) config.seed += n;
+    return std::unique_ptr<TurbulenceModel>(new TurbulenceModel(config));
+}
+
+Eigen::Vector3d WindService::wind_at(const Eigen::Vector3d& ned_position, double t) const {
+    Eigen::Vector3d wind = Eigen::Vector3d::Zero();
+    for (const auto& field : this->fields) wind += field->wind_at(ned_position, t);
+    return wind;
+}
+
+Eigen::Vector3d WindService::wind_at(const Eigen::Vector3d& ned_position) const {
+    return this->wind_at(ned_position, this->clock.get_current_time_us().count() / 1000000.0);
+}
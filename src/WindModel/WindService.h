@@ -0,0 +1,45 @@
+#ifndef __WINDSERVICE_H__
+#define __WINDSERVICE_H__
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <Eigen/Eigen>
+#include "WindField.h"
+#include "TurbulenceModel.h"
+#include "../Interfaces/Clock.h"
+
+/**
+ * Environment wide wind, shared by every vehicle of a simulation.
+ *
+ * The mean wind is the sum of the registered fields (constant wind, gusts,
+ * gridded fields...), evaluated at any position and time without locking.
+ * Turbulence is stateful and per vehicle: each vehicle gets its own model
+ * from make_turbulence(), seeded differently.
+ *
+ * Fields are expected to be registered during setup, before vehicles sample the wind.
+ */
+class WindService {
+private:
+    Clock& clock;
+    std::vector<std::shared_ptr<const WindField>> fields;
+    TurbulenceConfig turbulence_config;
+    std::atomic<uint32_t> turbulence_models_n{0};
+public:
+    WindService(Clock& clock) : clock(clock) {}
+    WindService(WindService& w) = delete;
+
+    void add_field(std::shared_ptr<const WindField> field) { this->fields.push_back(field); }
+    void set_turbulence(const TurbulenceConfig& config) { this->turbulence_config = config; }
+    bool has_turbulence() const { return this->turbulence_config.wind_speed_20ft > 0; }
+
+    // NULL when turbulence is disabled
+    std::unique_ptr<TurbulenceModel> make_turbulence();
+
+    // Mean wind (NED, m/s) at a NED position (m) and simulation time (s)
+    Eigen::Vector3d wind_at(const Eigen::Vector3d& ned_position, double t) const;
+    // Mean wind at the current simulation time
+    Eigen::Vector3d wind_at(const Eigen::Vector3d& ned_position) const;
+};
+
+#endif // __WINDSERVICE_H__
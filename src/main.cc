@@ -6,9 +6,19 @@
 #include "StandaloneDrone.h"
 #include <boost/thread.hpp>
 #include "Sockets/MAVLinkConnectionHandler.h"
+#include "WindModel/WindService.h"
+#include "Metrics/MetricsServer.h"
 #include <Eigen/Eigen>
+#include <csignal>
 
-int main()
+static Simulator* running_simulator = NULL;
+
+// SIGINT / SIGTERM end the simulation loop so that the profile and trace are written
+static void stop_simulation(int) {
+    if (running_simulator != NULL) running_simulator->stop();
+}
+
+int main(int argc, char** argv)
 {
 
     std::cout << "6 DOF Simulator" << std::endl;
@@ -20,18 +30,59 @@ int main()
     boost::asio::io_service service;
     boost::asio::io_service godot_service;
 
+    // SIM6DOF_TRACE=<file> records a Chrome trace (chrome://tracing, ui.perfetto.dev), written on exit
+    const char* trace_path = getenv("SIM6DOF_TRACE");
+    if (trace_path != NULL) TraceRecorder::shared_instance().start(trace_path);
+
+    // SIM6DOF_METRICS=<port> or unix:<path> serves Prometheus metrics while the simulation runs
+    std::unique_ptr<MetricsServer> metrics;
+    const char* metrics_endpoint = getenv("SIM6DOF_METRICS");
+    if (metrics_endpoint != NULL) {
+        metrics.reset(new MetricsServer(metrics_endpoint));
+        if (!metrics->start()) metrics.reset();
+    }
+
     MAVLinkConnectionHandler handler{service, ConnectionTarget::PX4};
-    boost::thread link_thread = boost::thread(boost::bind(&boost::asio::io_service::run, &service));
+    boost::thread link_thread = boost::thread([&service]() {
+        TraceRecorder::shared_instance().set_thread_name("link");
+        service.run();
+    });
     std::unique_ptr<Simulator> s(new Simulator({4000, 2, true}));
     GodotRouter r{godot_service, s->simulation_clock};
+
+    // ./6dof <capture file> records the PX4 session for offline replay
+    std::unique_ptr<MAVLinkCaptureWriter> capture;
+    if (argc > 1) {
+        capture.reset(new MAVLinkCaptureWriter(argv[1], s->simulation_clock));
+        handler.set_capture_writer(capture.get());
+    }
     
+    // Calm air: register fields (ConstantWind, GustProfile, GriddedWindField) and turbulence here
+    WindService wind{s->simulation_clock};
+
     Drone d{fixed_wing_config, handler, s->simulation_clock };
     d.set_fake_ground_level(0);
+    d.set_wind_service(wind);
     d.set_drone_state_processor(*s);
     s->add_environment_object(d);
     s->add_drone_state_processor(&r);
 
+    // SIM6DOF_PROFILE=<s> logs the tick profile every <s> seconds of wall time
+    const char* profile_period = getenv("SIM6DOF_PROFILE");
+    if (profile_period != NULL) {
+        s->enable_profiling(boost::chrono::microseconds((long long)(atof(profile_period) * 1000000)));
+    }
+
+    running_simulator = s.get();
+    std::signal(SIGINT, stop_simulation);
+    std::signal(SIGTERM, stop_simulation);
     s->start();
-    
+    running_simulator = NULL;
+
+    service.stop();
+    link_thread.join();
+    if (metrics) metrics->stop();
+    TraceRecorder::shared_instance().write();
+
     return 0;
 }
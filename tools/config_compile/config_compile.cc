@@ -0,0 +1,49 @@
+#include "../../src/Containers/DroneConfig.h"
+#include <stdio.h>
+
+/**
+ * Binary form of a vehicle file: the same document as CBOR,
+ * read back without text parsing.
+ */
+static std::vector<uint8_t> compiled_config(const nlohmann::json& data) {
+    std::vector<uint8_t> compiled(DRONE_CONFIG_COMPILED_MAGIC, DRONE_CONFIG_COMPILED_MAGIC + DRONE_CONFIG_COMPILED_MAGIC_SIZE);
+    nlohmann::json::to_cbor(data, compiled);
+    return compiled;
+}
+
+/**
+ * Validates a vehicle file and writes its compiled (binary) form,
+ * which Drone, StandaloneDrone and ConfigRegistry load like the JSON.
+ * PX4 parameters referenced by the file are folded in.
+ *
+ * Usage: config_compile <vehicle config> <output>
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <vehicle config> <output>\n", argv[0]);
+        return 1;
+    }
+
+    const char* config_path = argv[1];
+    const char* output_path = argv[2];
+
+    std::vector<uint8_t> compiled;
+    try {
+        // Rejects the files the simulator would reject
+        config_from_file_path(config_path);
+        compiled = compiled_config(resolve_config_file(config_path));
+    } catch (const ConfigError& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::ofstream fout(output_path, std::ios::binary);
+    fout.write((const char*)compiled.data(), compiled.size());
+    if (!fout) {
+        fprintf(stderr, "Cannot write %s\n", output_path);
+        return 1;
+    }
+    printf("%s -> %s (%zu bytes)\n", config_path, output_path, compiled.size());
+    return 0;
+}
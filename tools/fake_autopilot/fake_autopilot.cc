@@ -0,0 +1,218 @@
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+#include <mavlink.h>
+#include <boost/asio.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Loopback stand-in for PX4 in lockstep (HIL) mode.
+ *
+ * Connects to the simulator like PX4 does (TCP 4560), consumes HIL_SENSOR / HIL_GPS /
+ * HIL_STATE_QUATERNION and answers every HIL_SENSOR with a HIL_ACTUATOR_CONTROLS computed
+ * by a simple altitude + attitude hold controller.
+ *
+ * Reports the simulator round-trip latency (HIL_ACTUATOR_CONTROLS sent -> next HIL_SENSOR received)
+ * and the achieved lockstep rate.
+ *
+ * Usage: fake_autopilot [duration s] [host] [port] [hover throttle] [target altitude m]
+ */
+
+using namespace boost::asio;
+
+#define FAKE_AUTOPILOT_SYSTEM_ID 1
+#define FAKE_AUTOPILOT_COMPONENT_ID 1
+#define CONNECTION_ATTEMPTS 100
+
+struct VehicleEstimate {
+    double roll = 0, pitch = 0, yaw = 0;    // rad
+    double p = 0, q = 0, r = 0;             // rad/s (body)
+    double altitude_m = 0;                  // m above the first GPS fix
+    double climb_rate = 0;                  // m/s (positive up)
+    double initial_altitude_mm = NAN;
+};
+
+struct ControllerGains {
+    double hover_throttle;
+    double target_altitude_m;
+    double kp_alt = 0.15, kd_alt = 0.2;
+    double kp_att = 0.4, kd_att = 0.1;
+    double kd_yaw = 0.1;
+};
+
+static double percentile(std::vector<double>& sorted_samples, double p) {
+    if (sorted_samples.empty()) return 0;
+    size_t idx = std::min(sorted_samples.size() - 1, (size_t)std::floor(p / 100.0 * sorted_samples.size()));
+    return sorted_samples[idx];
+}
+
+static double clamp01(double v) { return std::max(0.0, std::min(1.0, v)); }
+
+/**
+ * Quad-X mixer matching the default rotor layout (see quad_x_rotors in RotorConfig.h).
+ * controls[0..3]: front-right, rear-left, front-left, rear-right
+ */
+static void mix(const VehicleEstimate& e, const ControllerGains& g, float* controls) {
+    double thrust = g.hover_throttle
+        + g.kp_alt * (g.target_altitude_m - e.altitude_m)
+        - g.kd_alt * e.climb_rate;
+    double roll = -g.kp_att * e.roll - g.kd_att * e.p;
+    double pitch = -g.kp_att * e.pitch - g.kd_att * e.q;
+    double yaw = -g.kd_yaw * e.r;
+
+    controls[0] = clamp01(thrust - roll + pitch + yaw);
+    controls[1] = clamp01(thrust + roll - pitch + yaw);
+    controls[2] = clamp01(thrust + roll + pitch - yaw);
+    controls[3] = clamp01(thrust - roll - pitch - yaw);
+}
+
+int main(int argc, char** argv)
+{
+    double duration_s = argc > 1 ? atof(argv[1]) : 10.0;
+    const char* host = argc > 2 ? argv[2] : "127.0.0.1";
+    int port = argc > 3 ? atoi(argv[3]) : 4560;
+    ControllerGains gains;
+    gains.hover_throttle = argc > 4 ? atof(argv[4]) : 0.6;
+    gains.target_altitude_m = argc > 5 ? atof(argv[5]) : 5.0;
+
+    io_service service;
+    ip::tcp::socket socket(service);
+    ip::tcp::endpoint endpoint(ip::address::from_string(host), port);
+    boost::system::error_code err;
+
+    for (auto attempt = 0; attempt < CONNECTION_ATTEMPTS; attempt++) {
+        socket.connect(endpoint, err);
+        if (!err) break;
+        socket.close();
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+    }
+    if (err) {
+        fprintf(stderr, "Could not connect to simulator at %s:%d (%s)\n", host, port, err.message().c_str());
+        return 1;
+    }
+    ip::tcp::no_delay no_delay(true);
+    socket.set_option(no_delay);
+    printf("Connected to simulator at %s:%d\n", host, port);
+
+    VehicleEstimate estimate;
+    std::vector<double> latencies_us;
+    uint64_t hil_sensor_n = 0, hil_gps_n = 0, hil_state_quaternion_n = 0, actuator_controls_n = 0;
+    uint64_t battery_status_n = 0;
+    mavlink_battery_status_t battery = {};
+    uint64_t first_sim_time_us = 0, last_sim_time_us = 0;
+    bool awaiting_reply = false;
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    boost::chrono::steady_clock::time_point last_sent = start;
+    boost::chrono::steady_clock::time_point deadline = start + boost::chrono::microseconds((long long)(duration_s * 1000000));
+
+    char buff[2048];
+    uint8_t out_buff[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t msg;
+    mavlink_status_t status;
+
+    while (boost::chrono::steady_clock::now() < deadline) {
+        size_t len = socket.read_some(buffer(buff, sizeof(buff)), err);
+        if (err) {
+            fprintf(stderr, "Connection closed by simulator (%s)\n", err.message().c_str());
+            break;
+        }
+        boost::chrono::steady_clock::time_point received_at = boost::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < len; i++) {
+            if (!mavlink_parse_char(MAVLINK_COMM_0, buff[i], &msg, &status)) continue;
+
+            switch (msg.msgid) {
+                case MAVLINK_MSG_ID_HIL_STATE_QUATERNION: {
+                    mavlink_hil_state_quaternion_t s;
+                    mavlink_msg_hil_state_quaternion_decode(&msg, &s);
+                    float* q = s.attitude_quaternion; // w x y z
+                    estimate.roll = atan2(2.0 * (q[0] * q[1] + q[2] * q[3]), 1.0 - 2.0 * (q[1] * q[1] + q[2] * q[2]));
+                    estimate.pitch = asin(std::max(-1.0, std::min(1.0, 2.0 * (q[0] * q[2] - q[3] * q[1]))));
+                    estimate.yaw = atan2(2.0 * (q[0] * q[3] + q[1] * q[2]), 1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3]));
+                    hil_state_quaternion_n++;
+                    break;
+                }
+                case MAVLINK_MSG_ID_HIL_GPS: {
+                    mavlink_hil_gps_t gps;
+                    mavlink_msg_hil_gps_decode(&msg, &gps);
+                    if (std::isnan(estimate.initial_altitude_mm)) estimate.initial_altitude_mm = gps.alt;
+                    estimate.altitude_m = (gps.alt - estimate.initial_altitude_mm) / 1000.0;
+                    estimate.climb_rate = -gps.vd / 100.0; // cm/s down to m/s up
+                    hil_gps_n++;
+                    break;
+                }
+                case MAVLINK_MSG_ID_HIL_SENSOR: {
+                    mavlink_hil_sensor_t sensor;
+                    mavlink_msg_hil_sensor_decode(&msg, &sensor);
+                    estimate.p = sensor.xgyro;
+                    estimate.q = sensor.ygyro;
+                    estimate.r = sensor.zgyro;
+
+                    if (hil_sensor_n++ == 0) first_sim_time_us = sensor.time_usec;
+                    last_sim_time_us = sensor.time_usec;
+
+                    // Frames already buffered before our last reply are not answers to it
+                    if (awaiting_reply && received_at > last_sent) {
+                        latencies_us.push_back(
+                            boost::chrono::duration_cast<boost::chrono::nanoseconds>(received_at - last_sent).count() / 1000.0
+                        );
+                        awaiting_reply = false;
+                    }
+
+                    mavlink_message_t controls_msg;
+                    float controls[16] = {0};
+                    mix(estimate, gains, controls);
+                    mavlink_msg_hil_actuator_controls_pack(
+                        FAKE_AUTOPILOT_SYSTEM_ID,
+                        FAKE_AUTOPILOT_COMPONENT_ID,
+                        &controls_msg,
+                        sensor.time_usec,
+                        controls,
+                        MAV_MODE_FLAG_SAFETY_ARMED,
+                        0
+                    );
+                    uint16_t out_len = mavlink_msg_to_send_buffer(out_buff, &controls_msg);
+                    write(socket, buffer(out_buff, out_len), err);
+                    if (err) break;
+                    last_sent = boost::chrono::steady_clock::now();
+                    awaiting_reply = true;
+                    actuator_controls_n++;
+                    break;
+                }
+                case MAVLINK_MSG_ID_BATTERY_STATUS: {
+                    mavlink_msg_battery_status_decode(&msg, &battery);
+                    battery_status_n++;
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    double wall_s = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - start).count() / 1000000.0;
+    double sim_s = (last_sim_time_us - first_sim_time_us) / 1000000.0;
+    std::sort(latencies_us.begin(), latencies_us.end());
+
+    printf("[FAKE AUTOPILOT REPORT]\n");
+    printf("\tHIL_SENSOR: %llu | HIL_GPS: %llu | HIL_STATE_QUATERNION: %llu | HIL_ACTUATOR_CONTROLS sent: %llu\n",
+        (unsigned long long)hil_sensor_n, (unsigned long long)hil_gps_n,
+        (unsigned long long)hil_state_quaternion_n, (unsigned long long)actuator_controls_n);
+    printf("\tLockstep rate: %f steps/s (wall time %f s)\n", wall_s > 0 ? hil_sensor_n / wall_s : 0.0, wall_s);
+    printf("\tSim time: %f s | real time factor: %fx\n", sim_s, wall_s > 0 ? sim_s / wall_s : 0.0);
+    printf("\tRound trip latency (us): p50 %f | p90 %f | p99 %f | max %f\n",
+        percentile(latencies_us, 50), percentile(latencies_us, 90), percentile(latencies_us, 99),
+        latencies_us.empty() ? 0.0 : latencies_us.back());
+    printf("\tBATTERY_STATUS: %llu | %f V | %f A | %d mAh | %d %%\n",
+        (unsigned long long)battery_status_n, battery.voltages[0] / 1000.0, battery.current_battery / 100.0,
+        battery.current_consumed, battery.battery_remaining);
+    printf("\tFinal altitude: %f m (target %f m)\n", estimate.altitude_m, gains.target_altitude_m);
+
+    return hil_sensor_n > 0 ? 0 : 1;
+}
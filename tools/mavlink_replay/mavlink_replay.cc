@@ -0,0 +1,63 @@
+#include "../../src/Logging/ConsoleLogger.h"
+#include "../../src/Logging/MAVLinkCapture.h"
+#include "../../src/Sockets/MAVLinkReplayRelay.h"
+#include "../../src/Simulator.h"
+#include "../../src/Drone.h"
+#include <boost/chrono.hpp>
+#include <stdlib.h>
+
+/**
+ * Replays the inbound traffic of a MAVLink capture (see ./6dof <capture file>)
+ * through the full Drone path, without PX4 and without sockets.
+ *
+ * Usage: mavlink_replay <capture> [vehicle config] [timestep us] [output capture]
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <capture> [vehicle config] [timestep us] [output capture]\n", argv[0]);
+        return 1;
+    }
+
+    const char* capture_path = argv[1];
+    const char* config_path = argc > 2 ? argv[2] : "../drone_models/small";
+    long timestep_us = argc > 3 ? atol(argv[3]) : 4000;
+    const char* output_path = argc > 4 ? argv[4] : NULL;
+
+    ConsoleLogger::shared_instance()->set_debug(false);
+
+    std::vector<MAVLinkCaptureRecord> records = MAVLinkCaptureReader::read_all(capture_path);
+    if (records.empty()) {
+        fprintf(stderr, "No frames in capture %s\n", capture_path);
+        return 1;
+    }
+
+    std::unique_ptr<Simulator> s(new Simulator({timestep_us, 1, true}));
+    MAVLinkReplayRelay relay{records, s->simulation_clock};
+
+    std::unique_ptr<MAVLinkCaptureWriter> output;
+    if (output_path != NULL) {
+        output.reset(new MAVLinkCaptureWriter(output_path, s->simulation_clock));
+        relay.set_capture_writer(output.get());
+    }
+
+    Drone d{config_path, relay, s->simulation_clock};
+    d.set_fake_ground_level(0);
+    d.set_drone_state_processor(*s);
+    // The relay must run before the drone so that each tick's frames are queued in time
+    s->add_environment_object(relay);
+    s->add_environment_object(d);
+
+    boost::chrono::steady_clock::time_point before = boost::chrono::steady_clock::now();
+    s->start(relay.get_capture_duration_us());
+    boost::chrono::steady_clock::time_point after = boost::chrono::steady_clock::now();
+
+    double wall_s = boost::chrono::duration_cast<boost::chrono::microseconds>(after - before).count() / 1000000.0;
+    double sim_s = s->simulation_clock.get_current_time_us().count() / 1000000.0;
+
+    printf("Replayed %s\n", relay.str().c_str());
+    printf("\tframes in: %llu | frames out: %llu\n", (unsigned long long)relay.get_frames_in(), (unsigned long long)relay.get_frames_out());
+    printf("\tsim time: %f s | wall time: %f s | speed: %fx\n", sim_s, wall_s, wall_s > 0 ? sim_s / wall_s : 0.0);
+
+    return 0;
+}